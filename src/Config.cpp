@@ -27,6 +27,7 @@
 #include "core/Platform.h"
 #include "core/View.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 
@@ -51,6 +52,7 @@ public:
 
     DockWidgetFactoryFunc m_dockWidgetFactoryFunc = nullptr;
     MainWindowFactoryFunc m_mainWindowFactoryFunc = nullptr;
+    GuestViewFactoryFunc m_guestViewFactoryFunc = nullptr;
     DropIndicatorAllowedFunc m_dropIndicatorAllowedFunc = nullptr;
     DragAboutToStartFunc m_dragAboutToStartFunc = nullptr;
     DragEndedFunc m_dragEndedFunc = nullptr;
@@ -62,6 +64,9 @@ public:
     bool m_transparencyOnlyOverDropIndicator = false;
     int m_mdiPopupThreshold = 250;
     int m_startDragDistance = -1;
+    int m_groupPoolSize = 0;
+    int m_floatingWindowPoolSize = 0;
+    int m_separatorPoolSize = 32;
     bool m_dropIndicatorsInhibited = false;
     bool m_layoutSaverStrictMode = false;
     bool m_onlyProgrammaticDrag = false;
@@ -95,7 +100,7 @@ void Config::setFlags(Flags f)
     // Some are. More can be supported but they need to be examined in a case-by-case
     // basis.
 
-    static const Flags mutableFlags = Flag::Flag_AutoHideAsTabGroups;
+    static const Flags mutableFlags = Flag::Flag_AutoHideAsTabGroups | Flag::Flag_CoalesceDragHover;
     const Flags changedFlags = f ^ d->m_flags;
     const bool nonMutableFlagsChanged = (changedFlags & ~mutableFlags);
 
@@ -141,6 +146,16 @@ MainWindowFactoryFunc Config::mainWindowFactoryFunc() const
     return d->m_mainWindowFactoryFunc;
 }
 
+void Config::setGuestViewFactoryFunc(GuestViewFactoryFunc func)
+{
+    d->m_guestViewFactoryFunc = func;
+}
+
+GuestViewFactoryFunc Config::guestViewFactoryFunc() const
+{
+    return d->m_guestViewFactoryFunc;
+}
+
 void Config::setViewFactory(ViewFactory *wf)
 {
     assert(wf);
@@ -363,6 +378,36 @@ int Config::startDragDistance() const
     return d->m_startDragDistance;
 }
 
+void Config::setGroupPoolSize(int size)
+{
+    d->m_groupPoolSize = size;
+}
+
+int Config::groupPoolSize() const
+{
+    return d->m_groupPoolSize;
+}
+
+void Config::setFloatingWindowPoolSize(int size)
+{
+    d->m_floatingWindowPoolSize = size;
+}
+
+int Config::floatingWindowPoolSize() const
+{
+    return d->m_floatingWindowPoolSize;
+}
+
+void Config::setSeparatorPoolSize(int size)
+{
+    d->m_separatorPoolSize = std::max(0, size);
+}
+
+int Config::separatorPoolSize() const
+{
+    return d->m_separatorPoolSize;
+}
+
 void Config::printDebug()
 {
     std::cerr << "Flags: " << d->m_flags << d->m_internalFlags << "\n";
@@ -34,6 +34,7 @@ class ViewFactory;
 
 typedef KDDockWidgets::Core::DockWidget *(*DockWidgetFactoryFunc)(const QString &name);
 typedef KDDockWidgets::Core::MainWindow *(*MainWindowFactoryFunc)(const QString &name, KDDockWidgets::MainWindowOptions);
+typedef void (*GuestViewFactoryFunc)(KDDockWidgets::Core::DockWidget *dockWidget);
 typedef bool (*DragAboutToStartFunc)(Core::Draggable *draggable);
 typedef void (*DragEndedFunc)();
 
@@ -129,6 +130,9 @@ public:
         Flag_AllowSwitchingTabsViaMenu = 0x80000, ///< Allow switching tabs via a context menu when
                                                   ///< right clicking on the tab area
         Flag_AutoHideAsTabGroups = 0x100000, ///< If tabbed dockwidgets are sent to/from sidebar, they're all sent and restored together
+        Flag_CoalesceDragHover = 0x200000, ///< While dragging a window, drop indicators are updated at most once per frame instead
+                                           ///< of on every mouse move. The window itself still follows the mouse immediately.
+                                           ///< Opt-in, it's not part of Flag_Default.
         Flag_Default = Flag_AeroSnapWithClientDecos ///< The defaults
     };
     Q_DECLARE_FLAGS(Flags, Flag)
@@ -214,6 +218,26 @@ public:
     /// nullptr by default
     MainWindowFactoryFunc mainWindowFactoryFunc() const;
 
+    /**
+     * @brief Registers a GuestViewFactoryFunc, for creating dock widget contents lazily.
+     *
+     * This is optional, the default is nullptr.
+     *
+     * When set, a dock widget without guest view gets one the first time it's open and is the
+     * current tab of its group. The function should call DockWidget::setGuestView(), or
+     * setWidget() in the QtWidgets frontend.
+     *
+     * Useful when the contents are expensive to create: the DockWidgetFactoryFunc can return
+     * empty dock widgets, and contents will only be created for the ones that are actually shown.
+     * While restoring a layout, this is only called once the restore is done, so background
+     * tabs and closed dock widgets stay empty.
+     */
+    void setGuestViewFactoryFunc(GuestViewFactoryFunc);
+
+    ///@brief Returns the GuestViewFactoryFunc.
+    /// nullptr by default
+    GuestViewFactoryFunc guestViewFactoryFunc() const;
+
     /**
      * @brief Sets the ViewFactory.
      *
@@ -364,6 +388,33 @@ public:
     /// Platform::startDragDistance() will be used
     int startDragDistance() const;
 
+    /// @brief Sets how many emptied groups are kept for reuse
+    /// Docking and undocking creates groups, each with its Stack, TabBar and TitleBar views,
+    /// and deletes the ones left empty. With a pool, emptied groups are reset and reused by the
+    /// next docking operation instead. Mostly useful for QtQuick, where creating these views
+    /// instantiates several QML components.
+    /// Default is 0, which disables recycling.
+    /// @warning QPointers to a recycled group aren't cleared, as it isn't deleted
+    void setGroupPoolSize(int);
+    int groupPoolSize() const;
+
+    /// @brief Sets how many hidden floating windows are kept ready for tearing off dock widgets
+    /// Creating a floating window creates a native window, which on some platforms is slow enough
+    /// to delay the start of the drag. With a pool, windows are pre-created while the event loop
+    /// is idle and are handed out instead. The size applies to each combination of parent main
+    /// window and FloatingWindowFlags that was used.
+    /// Default is 0, which disables the pool.
+    void setFloatingWindowPoolSize(int);
+    int floatingWindowPoolSize() const;
+
+    /// @brief Sets how many unused separators each layout keeps hidden for reuse
+    /// Separators no longer needed are pooled instead of deleted, so docking and undocking
+    /// doesn't recreate their views. Beyond this many, they're deleted.
+    /// Lowering it trims each layout's pool the next time one of its separators is released.
+    /// Default is 32. 0 disables pooling.
+    void setSeparatorPoolSize(int);
+    int separatorPoolSize() const;
+
     /// Prints some debug information
     void printDebug();
 
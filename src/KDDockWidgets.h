@@ -109,6 +109,13 @@ enum class LayoutSaverOption {
 };
 Q_DECLARE_FLAGS(LayoutSaverOptions, LayoutSaverOption)
 
+/// @brief The format LayoutSaver saves layouts in. Restoring detects the format automatically.
+enum class LayoutSaverFormat {
+    Json = 0, ///< Indented JSON. The default
+    Binary, ///< Smaller and faster to restore, but not human readable. Uses CBOR internally.
+};
+Q_ENUM_NS(LayoutSaverFormat)
+
 enum class IconPlace {
     TitleBar = 1,
     TabBar = 2,
@@ -245,6 +252,9 @@ enum RestoreOption {
            ///< relative sizing. Loading layouts won't change the main window geometry and just use
            ///< whatever the user has at the moment.
     RestoreOption_AbsoluteFloatingDockWindows = 2, ///< Skips scaling of floating dock windows relative to the main window.
+    RestoreOption_ReuseGroups = 4, ///< Main window groups which have the same tabs as in the saved layout are kept, instead of
+                                   ///< being destroyed and recreated. Their dock widgets aren't closed nor reparented.
+                                   ///< Useful when switching between similar layouts.
 };
 Q_DECLARE_FLAGS(RestoreOptions, RestoreOption)
 Q_ENUM_NS(RestoreOptions)
@@ -20,10 +20,13 @@
 #include "Config.h"
 #include "core/ViewFactory.h"
 #include "core/LayoutSaver_p.h"
+#include "core/JsonWriter_p.h"
 #include "core/Logging_p.h"
 #include "core/Position_p.h"
+#include "core/Tracing_p.h"
 #include "core/Utils_p.h"
 #include "core/View_p.h"
+#include "core/DelayedCall_p.h"
 
 #include "core/DockRegistry.h"
 #include "core/Platform.h"
@@ -39,6 +42,8 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstring>
+#include <thread>
 #include <utility>
 
 /**
@@ -80,6 +85,10 @@ inline InternalRestoreOptions internalRestoreOptions(RestoreOptions options)
         ret.setFlag(InternalRestoreOption::RelativeFloatingWindowGeometry, false);
         options.setFlag(RestoreOption_AbsoluteFloatingDockWindows, false);
     }
+    if (options.testFlag(RestoreOption_ReuseGroups)) {
+        ret.setFlag(InternalRestoreOption::ReuseGroups);
+        options.setFlag(RestoreOption_ReuseGroups, false);
+    }
 
     if (options != RestoreOption_None) {
         KDDW_ERROR("Unknown options={}", int(options));
@@ -382,17 +391,18 @@ LayoutSaver::~LayoutSaver()
 
 bool LayoutSaver::saveToFile(const QString &jsonFilename)
 {
-    const QByteArray data = serializeLayout();
-
     std::ofstream file(jsonFilename.toStdString(), std::ios::binary);
     if (!file.is_open()) {
         KDDW_ERROR("Failed to open {}", jsonFilename);
         return false;
     }
 
-    file.write(data.constData(), data.size());
+    const bool ok = d->serializeLayout([&file](const char *data, std::size_t size) {
+        file.write(data, std::streamsize(size));
+    });
+
     file.close();
-    return true;
+    return ok;
 }
 
 bool LayoutSaver::restoreFromFile(const QString &jsonFilename)
@@ -408,48 +418,69 @@ bool LayoutSaver::restoreFromFile(const QString &jsonFilename)
 
 QByteArray LayoutSaver::serializeLayout() const
 {
-    if (!d->m_dockRegistry->isSane()) {
+    QByteArray data;
+    serializeLayout(data);
+    return data;
+}
+
+bool LayoutSaver::serializeLayout(QByteArray &buffer) const
+{
+    buffer.resize(0);
+
+    return d->serializeLayout([&buffer](const char *data, std::size_t size) {
+        buffer.append(data, int(size));
+    });
+}
+
+bool LayoutSaver::Private::serializeLayout(const std::function<void(const char *, std::size_t)> &sink) const
+{
+    KDDW_TRACE_SCOPE("LayoutSaver::serializeLayout");
+    if (!m_dockRegistry->isSane()) {
         KDDW_ERROR("Refusing to serialize this layout. Check previous warnings.");
-        return {};
+        return false;
+    }
+
+    // Just a simplification. One less type of windows to handle.
+    m_dockRegistry->ensureAllFloatingWidgetsAreMorphed();
+
+    if (m_format == LayoutSaverFormat::Binary) {
+        sink(Layout::s_binaryHeader, sizeof(Layout::s_binaryHeader));
+        JsonWriter writer(sink, JsonWriter::Encoding::Cbor);
+        writeLayout(writer);
+    } else {
+        JsonWriter writer(sink);
+        writeLayout(writer);
     }
 
+    return true;
+}
+
+#ifdef DOCKS_TESTING_METHODS
+QByteArray LayoutSaver::Private::serializeThroughLayout() const
+{
     LayoutSaver::Layout layout;
 
     // Just a simplification. One less type of windows to handle.
-    d->m_dockRegistry->ensureAllFloatingWidgetsAreMorphed();
+    m_dockRegistry->ensureAllFloatingWidgetsAreMorphed();
 
-    const auto mainWindows = d->m_dockRegistry->mainwindows();
-    layout.mainWindows.reserve(mainWindows.size());
-    for (auto mainWindow : mainWindows) {
-        if (d->matchesAffinity(mainWindow->affinities()))
+    for (Core::MainWindow *mainWindow : m_dockRegistry->mainwindows()) {
+        if (matchesAffinity(mainWindow->affinities()))
             layout.mainWindows.push_back(mainWindow->serialize());
     }
 
-    const Vector<Core::FloatingWindow *> floatingWindows =
-        d->m_dockRegistry->floatingWindows(/*includeBeingDeleted=*/false, /*honourSkipped=*/true);
-    layout.floatingWindows.reserve(floatingWindows.size());
-    for (Core::FloatingWindow *floatingWindow : floatingWindows) {
-        if (d->matchesAffinity(floatingWindow->affinities()))
+    for (Core::FloatingWindow *floatingWindow : m_dockRegistry->floatingWindows(/*includeBeingDeleted=*/false, /*honourSkipped=*/true)) {
+        if (matchesAffinity(floatingWindow->affinities()))
             layout.floatingWindows.push_back(floatingWindow->serialize());
     }
 
-    // Closed dock widgets also have interesting things to save, like geometry and placeholder info
-    const Core::DockWidget::List closedDockWidgets = d->m_dockRegistry->closedDockwidgets(/*honourSkipped=*/true);
-    layout.closedDockWidgets.reserve(closedDockWidgets.size());
-    for (Core::DockWidget *dockWidget : closedDockWidgets) {
-        if (d->matchesAffinity(dockWidget->affinities()))
+    for (Core::DockWidget *dockWidget : m_dockRegistry->closedDockwidgets(/*honourSkipped=*/true)) {
+        if (matchesAffinity(dockWidget->affinities()))
             layout.closedDockWidgets.push_back(dockWidget->d->serialize());
     }
 
-    // Save the placeholder info. We do it last, as we also restore it last, since we need all items
-    // to be created before restoring the placeholders
-
-    const Core::DockWidget::List dockWidgets = d->m_dockRegistry->dockwidgets();
-    layout.allDockWidgets.reserve(dockWidgets.size());
-    for (Core::DockWidget *dockWidget : dockWidgets) {
+    for (Core::DockWidget *dockWidget : m_dockRegistry->dockwidgets()) {
         const bool skipsRestore = dockWidget->layoutSaverOptions() & LayoutSaverOption::Skip;
-
-        if (!skipsRestore && d->matchesAffinity(dockWidget->affinities())) {
+        if (!skipsRestore && matchesAffinity(dockWidget->affinities())) {
             auto dw = dockWidget->d->serialize();
             dw->lastPosition = dockWidget->d->lastPosition()->serialize();
             layout.allDockWidgets.push_back(dw);
@@ -458,60 +489,264 @@ QByteArray LayoutSaver::serializeLayout() const
 
     return layout.toJson();
 }
+#endif
+
+void LayoutSaver::Private::writeLayout(JsonWriter &writer) const
+{
+    // Same JSON as LayoutSaver::Layout's to_json(). Keys are written in the alphabetical order
+    // nlohmann::json sorts them in, so output is byte-identical.
+    writer.beginObject();
+
+    // Save the placeholder info. We also restore it last, since we need all items to be
+    // created before restoring the placeholders.
+    // Like with to_json(), an empty list of dock widgets is written as null.
+    writer.key("allDockWidgets");
+    bool hasDockWidgets = false;
+    for (Core::DockWidget *dockWidget : m_dockRegistry->dockwidgets()) {
+        const bool skipsRestore = dockWidget->layoutSaverOptions() & LayoutSaverOption::Skip;
+        if (!skipsRestore && matchesAffinity(dockWidget->affinities())) {
+            if (!hasDockWidgets) {
+                writer.beginArray();
+                hasDockWidgets = true;
+            }
+            dockWidget->d->serialize(writer);
+        }
+    }
+    if (hasDockWidgets)
+        writer.endArray();
+    else
+        writer.nullValue();
+
+    // Closed dock widgets also have interesting things to save, like geometry and placeholder info
+    writer.key("closedDockWidgets");
+    bool hasClosedDockWidgets = false;
+    for (Core::DockWidget *dockWidget : m_dockRegistry->closedDockwidgets(/*honourSkipped=*/true)) {
+        if (matchesAffinity(dockWidget->affinities())) {
+            if (!hasClosedDockWidgets) {
+                writer.beginArray();
+                hasClosedDockWidgets = true;
+            }
+            writer.value(dockWidget->uniqueName());
+        }
+    }
+    if (hasClosedDockWidgets)
+        writer.endArray();
+    else
+        writer.nullValue();
+
+    writer.key("floatingWindows");
+    writer.beginArray();
+    for (Core::FloatingWindow *floatingWindow : m_dockRegistry->floatingWindows(/*includeBeingDeleted=*/false, /*honourSkipped=*/true)) {
+        if (matchesAffinity(floatingWindow->affinities()))
+            floatingWindow->serialize(writer);
+    }
+    writer.endArray();
+
+    writer.key("mainWindows");
+    writer.beginArray();
+    for (Core::MainWindow *mainWindow : m_dockRegistry->mainwindows()) {
+        if (matchesAffinity(mainWindow->affinities()))
+            mainWindow->serialize(writer);
+    }
+    writer.endArray();
+
+    writer.key("screenInfo");
+    writer.beginArray();
+    const auto screens = Platform::instance()->screens();
+    for (int i = 0; i < screens.size(); ++i) {
+        writer.beginObject();
+        writer.key("devicePixelRatio");
+        writer.value(screens[i]->devicePixelRatio());
+        writer.key("geometry");
+        writer.value(screens[i]->geometry());
+        writer.key("index");
+        writer.value(i);
+        writer.key("name");
+        writer.value(screens[i]->name());
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.key("serializationVersion");
+    writer.value(KDDOCKWIDGETS_SERIALIZATION_VERSION);
+
+    writer.endObject();
+}
 
 bool LayoutSaver::restoreLayout(const QByteArray &data)
 {
-    LayoutSaver::DockWidget::s_dockWidgets.clear();
-    d->clearRestoredProperty();
-    if (data.isEmpty())
+    if (data.isEmpty()) {
+        LayoutSaver::DockWidget::s_dockWidgets.clear();
+        d->clearRestoredProperty();
         return true;
+    }
+
+    return d->restoreParsedLayout(Private::parseLayoutData(data));
+}
+
+namespace {
+
+/// State shared between restoreLayoutAsync(), its worker thread and ApplyParsedLayout.
+/// Only plain data, nothing tied to the GUI or to global state.
+struct AsyncRestore
+{
+    /// Copies of the caller's options, so the caller's LayoutSaver doesn't need to outlive the restore
+    InternalRestoreOptions restoreOptions;
+    Vector<QString> affinityNames;
+    std::function<void(bool)> callback;
+
+    /// Filled by the worker, discarded if the data couldn't be parsed
+    nlohmann::json dom;
+    bool isEmpty = false;
+};
+
+/// Posted to the GUI thread by the worker once it's done parsing
+class ApplyParsedLayout : public DelayedCall
+{
+public:
+    explicit ApplyParsedLayout(std::shared_ptr<AsyncRestore> restore)
+        : m_restore(std::move(restore))
+    {
+    }
+
+    void call() override
+    {
+        // LayoutSaver registers itself in DockRegistry, so it's only created here, on the GUI thread
+        LayoutSaver saver;
+        LayoutSaver::Private *d = saver.dptr();
+        d->m_restoreOptions = m_restore->restoreOptions;
+        d->m_affinityNames = m_restore->affinityNames;
+
+        const bool ok = m_restore->isEmpty ? saver.restoreLayout({}) : d->restoreParsedLayout(m_restore->dom);
+        if (m_restore->callback)
+            m_restore->callback(ok);
+    }
+
+    KDDW_DELETE_COPY_CTOR(ApplyParsedLayout)
+
+private:
+    const std::shared_ptr<AsyncRestore> m_restore;
+};
+
+}
+
+LayoutSaver::DockWidget::Ptr LayoutSaver::DockWidget::dockWidgetForName(const QString &name)
+{
+    auto it = s_dockWidgets.find(name);
+    auto dw = it == s_dockWidgets.cend() ? nullptr : it->second;
+    if (dw)
+        return dw;
+
+    dw = Ptr(new LayoutSaver::DockWidget);
+    s_dockWidgets[name] = dw;
+    dw->uniqueName = name;
+
+    return dw;
+}
+
+void LayoutSaver::restoreLayoutAsync(const QByteArray &data, std::function<void(bool)> callback)
+{
+    auto restore = std::make_shared<AsyncRestore>();
+    restore->restoreOptions = d->m_restoreOptions;
+    restore->affinityNames = d->m_affinityNames;
+    restore->callback = std::move(callback);
+
+    if (data.isEmpty()) {
+        // Nothing to parse, but still call back later, like for any other layout
+        restore->isEmpty = true;
+        Platform::instance()->runDelayed(0, new ApplyParsedLayout(std::move(restore)));
+        return;
+    }
+
+    // The worker only parses into a plain document. LayoutSaver::Layout is built from it on the
+    // GUI thread, as building it uses global state.
+    std::thread([platform = Platform::instance(), restore = std::move(restore), data]() mutable {
+        restore->dom = Private::parseLayoutData(data);
+        platform->runOnMainThread(new ApplyParsedLayout(std::move(restore)));
+    }).detach();
+}
+
+bool LayoutSaver::Private::restoreParsedLayout(const nlohmann::json &dom)
+{
+    LayoutSaver::DockWidget::s_dockWidgets.clear();
+    clearRestoredProperty();
+
+    LayoutSaver::Layout layout;
+    if (dom.is_discarded() || !layout.fromDom(dom)) {
+        KDDW_ERROR("Failed to parse layout data");
+        deleteEmptyGroups();
+        return false;
+    }
 
+    if (!layout.isValid()) {
+        deleteEmptyGroups();
+        return false;
+    }
+
+    return applyLayout(layout);
+}
+
+bool LayoutSaver::Private::applyLayout(LayoutSaver::Layout &layout)
+{
+    KDDW_TRACE_SCOPE("LayoutSaver::applyLayout");
     struct FrameCleanup
     {
-        explicit FrameCleanup(LayoutSaver *saver)
+        explicit FrameCleanup(LayoutSaver::Private *saver)
             : m_saver(saver)
         {
         }
 
         ~FrameCleanup()
         {
-            m_saver->d->deleteEmptyGroups();
+            m_saver->deleteEmptyGroups();
         }
 
         FrameCleanup(const FrameCleanup &) = delete;
         FrameCleanup &operator=(const FrameCleanup) = delete;
 
-        LayoutSaver *const m_saver;
+        LayoutSaver::Private *const m_saver;
     };
 
     FrameCleanup cleanup(this);
-    LayoutSaver::Layout layout;
-    if (!layout.fromJson(data)) {
-        KDDW_ERROR("Failed to parse json data");
-        return false;
-    }
 
-    if (!layout.isValid()) {
-        return false;
-    }
+    layout.scaleSizes(m_restoreOptions);
+
+    floatWidgetsWhichSkipRestore(layout.mainWindowNames());
+    floatUnknownWidgets(layout);
 
-    layout.scaleSizes(d->m_restoreOptions);
+    // Dock widgets without guest view only get one once restore is done, and only if they ended up
+    // visible. See Config::setGuestViewFactoryFunc(). Declared before isRestoring, so it runs after.
+    struct CreateVisibleGuestViews
+    {
+        CreateVisibleGuestViews() = default;
+        ~CreateVisibleGuestViews()
+        {
+            // Copied, as the factory might create more dock widgets
+            const Core::DockWidget::List dockWidgets = DockRegistry::self()->dockwidgets();
+            for (Core::DockWidget *dw : dockWidgets)
+                dw->d->maybeCreateGuestView();
+        }
 
-    d->floatWidgetsWhichSkipRestore(layout.mainWindowNames());
-    d->floatUnknownWidgets(layout);
+        KDDW_DELETE_COPY_CTOR(CreateVisibleGuestViews)
+    };
 
+    CreateVisibleGuestViews createGuestViews;
     Private::RAIIIsRestoring isRestoring;
 
     // Hide all dockwidgets and unparent them from any layout before starting restore
     // We only close the stuff that the loaded JSON knows about. Unknown widgets might be newer.
 
-    d->m_dockRegistry->clear(d->m_dockRegistry->dockWidgets(layout.dockWidgetsToClose()),
-                             d->m_dockRegistry->mainWindows(layout.mainWindowNames()),
-                             d->m_affinityNames);
+    Core::DockWidget::List dockWidgetsToClose = m_dockRegistry->dockWidgets(layout.dockWidgetsToClose());
+    if (m_restoreOptions & InternalRestoreOption::ReuseGroups)
+        reuseUnchangedGroups(layout, dockWidgetsToClose);
+
+    m_dockRegistry->clear(dockWidgetsToClose, m_dockRegistry->mainWindows(layout.mainWindowNames()),
+                          m_affinityNames);
 
     // 1. Restore main windows
     for (const LayoutSaver::MainWindow &mw : std::as_const(layout.mainWindows)) {
-        auto mainWindow = d->m_dockRegistry->mainWindowByName(mw.uniqueName);
+        KDDW_TRACE_SCOPE("LayoutSaver::restoreMainWindow");
+        auto mainWindow = m_dockRegistry->mainWindowByName(mw.uniqueName);
         if (!mainWindow) {
             if (auto mwFunc = Config::self().mainWindowFactoryFunc()) {
                 mainWindow = mwFunc(mw.uniqueName, mw.options);
@@ -521,12 +756,12 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
             }
         }
 
-        if (!d->matchesAffinity(mainWindow->affinities()))
+        if (!matchesAffinity(mainWindow->affinities()))
             continue;
 
-        if (!(d->m_restoreOptions & InternalRestoreOption::SkipMainWindowGeometry)) {
+        if (!(m_restoreOptions & InternalRestoreOption::SkipMainWindowGeometry)) {
             Window::Ptr window = mainWindow->view()->window();
-            d->deserializeWindowGeometry(mw, window);
+            deserializeWindowGeometry(mw, window);
             if (mw.windowState != WindowState::None) {
                 if (auto w = mainWindow->view()->window()) {
                     w->setWindowState(mw.windowState);
@@ -540,16 +775,18 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
 
     // 2. Restore FloatingWindows
     for (LayoutSaver::FloatingWindow &fw : layout.floatingWindows) {
-        if (!d->matchesAffinity(fw.affinities) || fw.skipsRestore())
+        if (!matchesAffinity(fw.affinities) || fw.skipsRestore())
             continue;
 
+        KDDW_TRACE_SCOPE("LayoutSaver::restoreFloatingWindow");
+
         auto parent =
             fw.parentIndex == -1 ? nullptr : DockRegistry::self()->mainwindows().at(fw.parentIndex);
 
         auto floatingWindow =
             new Core::FloatingWindow({}, parent, static_cast<FloatingWindowFlags>(fw.flags));
         fw.floatingWindowInstance = floatingWindow;
-        d->deserializeWindowGeometry(fw, floatingWindow->view()->window());
+        deserializeWindowGeometry(fw, floatingWindow->view()->window());
         if (!floatingWindow->deserialize(fw)) {
             KDDW_ERROR("Failed to deserialize floating window");
             return false;
@@ -559,17 +796,17 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
     // 3. Restore closed dock widgets. They remain closed but acquire geometry and placeholder
     // properties
     for (const auto &dw : std::as_const(layout.closedDockWidgets)) {
-        if (d->matchesAffinity(dw->affinities)) {
+        if (matchesAffinity(dw->affinities)) {
             Core::DockWidget::deserialize(dw);
         }
     }
 
     // 4. Restore the placeholder info, now that the Items have been created
     for (const auto &dw : std::as_const(layout.allDockWidgets)) {
-        if (!d->matchesAffinity(dw->affinities))
+        if (!matchesAffinity(dw->affinities))
             continue;
 
-        if (Core::DockWidget *dockWidget = d->m_dockRegistry->dockByName(
+        if (Core::DockWidget *dockWidget = m_dockRegistry->dockByName(
                 dw->uniqueName, DockRegistry::DockByNameFlag::ConsultRemapping)) {
             dockWidget->d->lastPosition()->deserialize(dw->lastPosition);
         } else {
@@ -589,6 +826,16 @@ void LayoutSaver::setAffinityNames(const Vector<QString> &affinityNames)
     }
 }
 
+void LayoutSaver::setFormat(LayoutSaverFormat format)
+{
+    d->m_format = format;
+}
+
+LayoutSaverFormat LayoutSaver::format() const
+{
+    return d->m_format;
+}
+
 LayoutSaver::Private *LayoutSaver::dptr() const
 {
     return d;
@@ -681,6 +928,48 @@ void LayoutSaver::Private::floatUnknownWidgets(const LayoutSaver::Layout &layout
     }
 }
 
+void LayoutSaver::Private::reuseUnchangedGroups(LayoutSaver::Layout &layout,
+                                               Core::DockWidget::List &dockWidgetsToClose)
+{
+    for (LayoutSaver::MainWindow &mw : layout.mainWindows) {
+        Core::MainWindow *mainWindow = m_dockRegistry->mainWindowByName(mw.uniqueName);
+        if (!mainWindow || mainWindow->isMDI() || !matchesAffinity(mainWindow->affinities()))
+            continue;
+
+        for (auto &it : mw.multiSplitterLayout.groups) {
+            LayoutSaver::Group &saved = it.second;
+            const int count = int(saved.dockWidgets.size());
+            if (count == 0)
+                continue;
+
+            // Dock widgets are only in one group, so the first one tells us the candidate
+            Core::DockWidget *first = m_dockRegistry->dockByName(
+                saved.dockWidgets.first()->uniqueName, DockRegistry::DockByNameFlag::ConsultRemapping);
+            Core::Group *group = first ? first->d->group() : nullptr;
+            if (!group || group->mainWindow() != mainWindow || group->isOverlayed()
+                || !group->layoutItem() || group->options() != FrameOptions(saved.options)
+                || group->dockWidgetCount() != count)
+                continue;
+
+            bool sameTabs = true;
+            for (int i = 0; i < count && sameTabs; ++i) {
+                sameTabs = group->dockWidgetAt(i)
+                    == m_dockRegistry->dockByName(saved.dockWidgets.at(i)->uniqueName,
+                                                  DockRegistry::DockByNameFlag::ConsultRemapping);
+            }
+
+            if (!sameTabs)
+                continue;
+
+            saved.reusedGroup = group;
+            for (Core::DockWidget *dw : group->dockWidgets()) {
+                dockWidgetsToClose.removeOne(dw);
+                dw->d->lastPosition()->removePlaceholders();
+            }
+        }
+    }
+}
+
 void LayoutSaver::Private::deleteEmptyGroups() const
 {
     // After a restore it can happen that some DockWidgets didn't exist, so weren't restored.
@@ -773,19 +1062,104 @@ bool LayoutSaver::Layout::fromJson(const QByteArray &jsonData)
         return false;
     }
 
+    return fromDom(json);
+}
+
+bool LayoutSaver::Layout::fromDom(const nlohmann::json &json)
+{
     try {
         from_json(json, *this);
     } catch (const std::exception &e) {
-        KDDW_ERROR("LayoutSaver::Layout::fromJson: Caught exception: {}", e.what());
+        KDDW_ERROR("LayoutSaver::Layout::fromDom: Caught exception: {}", e.what());
         return false;
     } catch (...) {
-        KDDW_ERROR("LayoutSaver::Layout::fromJson: Caught exception.");
+        KDDW_ERROR("LayoutSaver::Layout::fromDom: Caught exception.");
         return false;
     }
 
     return true;
 }
 
+namespace {
+
+/// Encodes @p json as a binary layout: the header followed by CBOR
+QByteArray binaryFromDom(const nlohmann::json &json)
+{
+    const std::vector<uint8_t> cbor = nlohmann::json::to_cbor(json);
+
+    QByteArray data;
+    data.reserve(int(sizeof(LayoutSaver::Layout::s_binaryHeader) + cbor.size()));
+    data.append(LayoutSaver::Layout::s_binaryHeader, int(sizeof(LayoutSaver::Layout::s_binaryHeader)));
+    data.append(reinterpret_cast<const char *>(cbor.data()), int(cbor.size()));
+    return data;
+}
+
+/// Decodes a binary layout. Returns a discarded value if it isn't valid CBOR.
+nlohmann::json domFromBinary(const QByteArray &data)
+{
+    const auto begin = reinterpret_cast<const uint8_t *>(data.constData()) + sizeof(LayoutSaver::Layout::s_binaryHeader);
+    const auto end = reinterpret_cast<const uint8_t *>(data.constData()) + data.size();
+    return nlohmann::json::from_cbor(begin, end, /*strict=*/true, /*allow_exceptions=*/false);
+}
+
+}
+
+nlohmann::json LayoutSaver::Private::parseLayoutData(const QByteArray &data)
+{
+    KDDW_TRACE_SCOPE("LayoutSaver::parseLayoutData");
+    if (Layout::isBinary(data))
+        return domFromBinary(data);
+
+    return nlohmann::json::parse(data, nullptr, /*allow_exceptions=*/false);
+}
+
+QByteArray LayoutSaver::convertLayout(const QByteArray &data, LayoutSaverFormat format)
+{
+    const bool isBinary = Layout::isBinary(data);
+    const nlohmann::json json = isBinary ? domFromBinary(data) : nlohmann::json::parse(data, nullptr, /*allow_exceptions=*/false);
+    if (json.is_discarded()) {
+        KDDW_ERROR("LayoutSaver::convertLayout: Failed to parse {} layout", isBinary ? "binary" : "json");
+        return {};
+    }
+
+    if (format == LayoutSaverFormat::Binary)
+        return binaryFromDom(json);
+
+    return QByteArray::fromStdString(json.dump(4));
+}
+
+QByteArray LayoutSaver::Layout::toBinary() const
+{
+    const nlohmann::json json = *this;
+    return binaryFromDom(json);
+}
+
+bool LayoutSaver::Layout::fromBinary(const QByteArray &data)
+{
+    if (!isBinary(data)) {
+        KDDW_ERROR("LayoutSaver::Layout::fromBinary: Unknown header");
+        return false;
+    }
+
+    nlohmann::json json = domFromBinary(data);
+    if (json.is_discarded()) {
+        return false;
+    }
+
+    return fromDom(json);
+}
+
+bool LayoutSaver::Layout::isBinary(const QByteArray &data)
+{
+    return std::size_t(data.size()) >= sizeof(s_binaryHeader)
+        && std::memcmp(data.constData(), s_binaryHeader, sizeof(s_binaryHeader)) == 0;
+}
+
+bool LayoutSaver::Layout::fromData(const QByteArray &data)
+{
+    return isBinary(data) ? fromBinary(data) : fromJson(data);
+}
+
 void LayoutSaver::Layout::scaleSizes(InternalRestoreOptions options)
 {
     if (mainWindows.isEmpty())
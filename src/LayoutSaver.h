@@ -23,6 +23,8 @@
 
 #include "kddockwidgets/KDDockWidgets.h"
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QByteArray;
 QT_END_NAMESPACE
@@ -39,7 +41,7 @@ class DockWidget;
  * @brief LayoutSaver allows to save or restore layouts.
  *
  * You can save a layout to a file or to a byte array.
- * JSON is used as the serialized format.
+ * JSON is used as the serialized format, unless setFormat() requests binary.
  *
  * Example:
  *     LayoutSaver saver;
@@ -65,14 +67,14 @@ public:
     static bool restoreInProgress();
 
     /**
-     * @brief saves the layout to JSON file
+     * @brief saves the layout to JSON file, or binary, see setFormat()
      * @param jsonFilename the filename where the layout will be saved to
      * @return true on success
      */
     bool saveToFile(const QString &jsonFilename);
 
     /**
-     * @brief restores the layout from a JSON file
+     * @brief restores the layout from a JSON or binary file. The format is detected automatically.
      * @param jsonFilename the filename containing a saved layout
      * @return true on success
      */
@@ -83,8 +85,20 @@ public:
      */
     QByteArray serializeLayout() const;
 
+    /**
+     * @brief saves the layout into @p buffer, replacing its contents
+     *
+     * The JSON is written directly from the live layout, without intermediate copies, and
+     * @p buffer's capacity is reused. Useful for saving large layouts often.
+     * The result is the same as with the overload above.
+     *
+     * @return false if the layout isn't in a state that can be saved
+     */
+    bool serializeLayout(QByteArray &buffer) const;
+
     /**
      * @brief restores the layout from a byte array
+     * Both JSON and binary layouts are accepted, the format is detected from the data.
      * All MainWindows and DockWidgets should have been created before calling
      * this function.
      *
@@ -97,6 +111,22 @@ public:
      */
     bool restoreLayout(const QByteArray &);
 
+    /**
+     * @brief restores the layout from a byte array, without blocking the GUI thread while parsing
+     *
+     * Same as restoreLayout(), but parsing @p data happens on a worker thread.
+     * The event loop keeps running meanwhile, so the application can show a splash screen or keep
+     * animating. The layout is then applied on the GUI thread and @p callback is called with the
+     * result, like restoreLayout() would have returned.
+     *
+     * The restore uses a copy of this LayoutSaver's options and affinity names, so this
+     * LayoutSaver can be destroyed before it finishes.
+     * Windows and dock widgets shouldn't be created or deleted until @p callback is called.
+     *
+     * Requires a frontend that implements Core::Platform::runOnMainThread(). The Qt ones do.
+     */
+    void restoreLayoutAsync(const QByteArray &, std::function<void(bool)> callback = {});
+
     /**
      * @brief returns a list of dock widgets which were restored since the last
      * @ref restoreLayout() or @ref restoreFromFile()
@@ -115,6 +145,22 @@ public:
      */
     void setAffinityNames(const Vector<QString> &affinityNames);
 
+    /**
+     * @brief Sets the format used by saveToFile() and serializeLayout()
+     * Default is LayoutSaverFormat::Json.
+     * Binary layouts are smaller and restore faster, but can't be edited by hand.
+     * They can be converted to JSON and back with kddockwidgets_linter.
+     */
+    void setFormat(LayoutSaverFormat);
+    LayoutSaverFormat format() const;
+
+    /**
+     * @brief Converts a saved layout, JSON or binary, to @p format
+     * Only the encoding changes, the layout isn't validated nor restored.
+     * @return the converted layout, or an empty byte array if @p data couldn't be parsed
+     */
+    static QByteArray convertLayout(const QByteArray &data, LayoutSaverFormat format);
+
     /// @internal Returns the private-impl. Not intended for public use.
     class Private;
     Private *dptr() const;
@@ -13,6 +13,10 @@
 #include "DockWidget_p.h"
 #include "Controller.h"
 #include "DragController_p.h"
+#include "DockRegistry.h"
+#include "Group.h"
+#include "GroupPool_p.h"
+#include "FloatingWindowPool_p.h"
 #include "core/Utils_p.h"
 
 using namespace KDDockWidgets::Core;
@@ -42,6 +46,37 @@ void DelayedDelete::call()
 }
 
 
+DelayedRecycleGroup::DelayedRecycleGroup(Group *group)
+    : m_group(group)
+{
+}
+
+DelayedRecycleGroup::~DelayedRecycleGroup() = default;
+
+void DelayedRecycleGroup::call()
+{
+    if (!m_group)
+        return;
+
+    if (!DockRegistry::self()->groupPool()->release(m_group))
+        delete m_group.data();
+}
+
+
+DelayedFillFloatingWindowPool::DelayedFillFloatingWindowPool(DockRegistry *registry)
+    : m_registry(registry)
+{
+}
+
+DelayedFillFloatingWindowPool::~DelayedFillFloatingWindowPool() = default;
+
+void DelayedFillFloatingWindowPool::call()
+{
+    if (m_registry)
+        m_registry->floatingWindowPool()->fillOne();
+}
+
+
 DelayedEmitFocusChanged::DelayedEmitFocusChanged(DockWidget *dw, bool focused)
     : m_dockWidget(dw)
     , m_focused(focused)
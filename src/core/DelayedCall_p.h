@@ -14,10 +14,15 @@
 #include "KDDockWidgets.h"
 #include "ObjectGuard_p.h"
 
+namespace KDDockWidgets {
+class DockRegistry;
+}
+
 namespace KDDockWidgets::Core {
 
 class DockWidget;
 class Controller;
+class Group;
 
 class DelayedCall
 {
@@ -42,6 +47,34 @@ private:
     ObjectGuard<Controller> m_object;
 };
 
+/// Like DelayedDelete, but gives the group to the GroupPool instead, if it has room
+class DelayedRecycleGroup : public DelayedCall
+{
+public:
+    explicit DelayedRecycleGroup(Group *);
+    ~DelayedRecycleGroup() override;
+
+    void call() override;
+
+    KDDW_DELETE_COPY_CTOR(DelayedRecycleGroup)
+private:
+    ObjectGuard<Group> m_group;
+};
+
+/// Creates a window for the FloatingWindowPool, unless the registry was meanwhile destroyed
+class DelayedFillFloatingWindowPool : public DelayedCall
+{
+public:
+    explicit DelayedFillFloatingWindowPool(DockRegistry *);
+    ~DelayedFillFloatingWindowPool() override;
+
+    void call() override;
+
+    KDDW_DELETE_COPY_CTOR(DelayedFillFloatingWindowPool)
+private:
+    ObjectGuard<DockRegistry> m_registry;
+};
+
 class DelayedEmitFocusChanged : public DelayedCall
 {
 public:
@@ -15,6 +15,7 @@
 #include "Config.h"
 #include "core/Logging_p.h"
 #include "core/Position_p.h"
+#include "core/Tracing_p.h"
 #include "core/Utils_p.h"
 #include "core/Platform_p.h"
 #include "core/WidgetResizeHandler_p.h"
@@ -27,14 +28,17 @@
 #include "core/FloatingWindow.h"
 #include "core/SideBar.h"
 #include "core/MainWindow.h"
+#include "core/MDILayout.h"
 #include "core/DockWidget.h"
 #include "core/DropArea.h"
+#include "core/Layout_p.h"
 #include "core/Platform.h"
 #include "core/Window_p.h"
 
 #include "kdbindings/signal.h"
 
 #include <set>
+#include <unordered_set>
 #include <utility>
 
 using namespace KDDockWidgets;
@@ -58,6 +62,26 @@ private:
 
 }
 
+/// Removes @p item from @p index, or points the index to another item with the same name, if there's
+/// duplicates. Duplicate names aren't supported, but they only trigger a warning when registering.
+template<typename T>
+static void removeFromNameIndex(std::unordered_map<QString, T *> &index, const Vector<T *> &items,
+                                T *item)
+{
+    const QString name = item->uniqueName();
+    auto it = index.find(name);
+    if (it == index.end() || it->second != item)
+        return;
+
+    index.erase(it);
+    for (T *other : items) {
+        if (other->uniqueName() == name) {
+            index.emplace(name, other);
+            return;
+        }
+    }
+}
+
 DockRegistry::DockRegistry(Core::Object *parent)
     : Core::Object(parent)
     , d(new Private())
@@ -71,6 +95,9 @@ DockRegistry::DockRegistry(Core::Object *parent)
 
 DockRegistry::~DockRegistry()
 {
+    d->m_inDtor = true;
+    d->m_floatingWindowPool.clear();
+    d->m_groupPool.clear();
     delete m_sideBarGroupings;
     Platform::instance()->removeGlobalEventFilter(this);
     d->m_connection.disconnect();
@@ -82,7 +109,7 @@ void DockRegistry::maybeDelete()
     // We delete the singleton just to make LSAN happy.
     // We could also simply ask the user do call something like KDDockWidgets::deinit() in the future,
     // Also, please don't change this to be deleted at static dtor time with Q_GLOBAL_STATIC.
-    if (isEmpty() && d->m_numLayoutSavers == 0)
+    if (isEmpty() && d->m_numLayoutSavers == 0 && !d->m_inDtor)
         delete this;
 }
 
@@ -257,14 +284,16 @@ Core::Group *DockRegistry::groupInMDIResize() const
         if (!mw->isMDI())
             continue;
 
-        Layout *layout = mw->layout();
-        const Vector<Core::Group *> groups = layout->groups();
-        for (Core::Group *group : groups) {
-            if (WidgetResizeHandler *wrh = group->resizeHandler()) {
-                if (wrh->isResizing())
-                    return group;
-            }
-        }
+        Core::Group *result = nullptr;
+        mw->layout()->visitGroups([&result](Core::Group *group) {
+            WidgetResizeHandler *wrh = group->resizeHandler();
+            if (wrh && wrh->isResizing())
+                result = group;
+            return !result;
+        });
+
+        if (result)
+            return result;
     }
 
     return nullptr;
@@ -324,6 +353,7 @@ void DockRegistry::registerDockWidget(Core::DockWidget *dock)
     }
 
     m_dockWidgets.push_back(dock);
+    d->m_dockWidgetsByName.emplace(dock->uniqueName(), dock);
 }
 
 void DockRegistry::unregisterDockWidget(Core::DockWidget *dock)
@@ -333,6 +363,7 @@ void DockRegistry::unregisterDockWidget(Core::DockWidget *dock)
 
     m_dockWidgets.removeOne(dock);
     m_sideBarGroupings->removeFromGroupings(dock);
+    removeFromNameIndex(d->m_dockWidgetsByName, m_dockWidgets, dock);
 
     maybeDelete();
 }
@@ -346,12 +377,23 @@ void DockRegistry::registerMainWindow(Core::MainWindow *mainWindow)
     }
 
     m_mainWindows.push_back(mainWindow);
+    d->m_mainWindowsByName.emplace(mainWindow->uniqueName(), mainWindow);
+    d->m_topLevelsGeneration++;
     Platform::instance()->onMainWindowCreated(mainWindow);
+
+    // Tearing off from this main window will want a floating window parented to it
+    const bool useParent = !(Config::self().internalFlags() & Config::InternalFlag_DontUseParentForFloatingWindows);
+    d->m_floatingWindowPool.scheduleFill(useParent ? mainWindow : nullptr, FloatingWindowFlag::FromGlobalConfig);
 }
 
 void DockRegistry::unregisterMainWindow(Core::MainWindow *mainWindow)
 {
+    // Before unregistering, so deleting them doesn't find us empty
+    d->m_floatingWindowPool.removeWindowsFor(mainWindow);
+
     m_mainWindows.removeOne(mainWindow);
+    removeFromNameIndex(d->m_mainWindowsByName, m_mainWindows, mainWindow);
+    d->m_topLevelsGeneration++;
     Platform::instance()->onMainWindowDestroyed(mainWindow);
     maybeDelete();
 }
@@ -359,12 +401,21 @@ void DockRegistry::unregisterMainWindow(Core::MainWindow *mainWindow)
 void DockRegistry::registerFloatingWindow(Core::FloatingWindow *fw)
 {
     m_floatingWindows.push_back(fw);
+    d->m_topLevelsGeneration++;
     Platform::instance()->onFloatingWindowCreated(fw);
 }
 
 void DockRegistry::unregisterFloatingWindow(Core::FloatingWindow *fw)
 {
     m_floatingWindows.removeOne(fw);
+    d->m_topLevelsGeneration++;
+    for (auto it = d->m_floatingWindowsByHandle.begin(); it != d->m_floatingWindowsByHandle.end();) {
+        if (it->second == fw) {
+            it = d->m_floatingWindowsByHandle.erase(it);
+        } else {
+            ++it;
+        }
+    }
     Platform::instance()->onFloatingWindowDestroyed(fw);
     maybeDelete();
 }
@@ -416,10 +467,9 @@ bool DockRegistry::containsMainWindow(const QString &uniqueName) const
 
 Core::DockWidget *DockRegistry::dockByName(const QString &name, DockByNameFlags flags) const
 {
-    for (auto dock : std::as_const(m_dockWidgets)) {
-        if (dock->uniqueName() == name)
-            return dock;
-    }
+    auto dockIt = d->m_dockWidgetsByName.find(name);
+    if (dockIt != d->m_dockWidgetsByName.cend())
+        return dockIt->second;
 
     if (flags.testFlag(DockByNameFlag::ConsultRemapping)) {
         // Name doesn't exist, let's check if it was remapped during a layout restore.
@@ -450,12 +500,8 @@ Core::DockWidget *DockRegistry::dockByName(const QString &name, DockByNameFlags
 
 Core::MainWindow *DockRegistry::mainWindowByName(const QString &name) const
 {
-    for (auto mainWindow : std::as_const(m_mainWindows)) {
-        if (mainWindow->uniqueName() == name)
-            return mainWindow;
-    }
-
-    return nullptr;
+    auto it = d->m_mainWindowsByName.find(name);
+    return it == d->m_mainWindowsByName.cend() ? nullptr : it->second;
 }
 
 bool DockRegistry::isSane() const
@@ -504,8 +550,10 @@ Core::DockWidget::List DockRegistry::dockWidgets(const Vector<QString> &names)
     Core::DockWidget::List result;
     result.reserve(names.size());
 
+    // Keeps the registration order, which callers might depend on
+    const std::unordered_set<QString> nameSet(names.cbegin(), names.cend());
     for (auto dw : std::as_const(m_dockWidgets)) {
-        if (names.contains(dw->uniqueName()))
+        if (nameSet.find(dw->uniqueName()) != nameSet.cend())
             result.push_back(dw);
     }
 
@@ -517,8 +565,9 @@ Core::MainWindow::List DockRegistry::mainWindows(const Vector<QString> &names)
     Core::MainWindow::List result;
     result.reserve(names.size());
 
+    const std::unordered_set<QString> nameSet(names.cbegin(), names.cend());
     for (auto mw : std::as_const(m_mainWindows)) {
-        if (names.contains(mw->uniqueName()))
+        if (nameSet.find(mw->uniqueName()) != nameSet.cend())
             result.push_back(mw);
     }
 
@@ -568,6 +617,16 @@ Core::Group::List DockRegistry::groups() const
     return m_groups;
 }
 
+Core::GroupPool *DockRegistry::groupPool() const
+{
+    return &d->m_groupPool;
+}
+
+Core::FloatingWindowPool *DockRegistry::floatingWindowPool() const
+{
+    return &d->m_floatingWindowPool;
+}
+
 Vector<Core::FloatingWindow *> DockRegistry::floatingWindows(bool includeBeingDeleted, bool honourSkipped) const
 {
     // Returns all the FloatingWindow which aren't being deleted
@@ -621,10 +680,25 @@ Core::FloatingWindow *DockRegistry::floatingWindowForHandle(Core::Window::Ptr wi
 
 Core::FloatingWindow *DockRegistry::floatingWindowForHandle(WId hwnd) const
 {
-    for (Core::FloatingWindow *fw : m_floatingWindows) {
+    auto handleMatches = [hwnd](Core::FloatingWindow *fw) {
         Window::Ptr window = fw->view()->window();
-        if (window && window->handle() == hwnd)
+        return window && window->handle() == hwnd;
+    };
+
+    auto &index = d->m_floatingWindowsByHandle;
+    auto it = index.find(hwnd);
+    if (it != index.end()) {
+        // The native window might have been recreated meanwhile
+        if (handleMatches(it->second))
+            return it->second;
+        index.erase(it);
+    }
+
+    for (Core::FloatingWindow *fw : m_floatingWindows) {
+        if (handleMatches(fw)) {
+            index[hwnd] = fw;
             return fw;
+        }
     }
 
     return nullptr;
@@ -683,6 +757,7 @@ void DockRegistry::clear(const Core::DockWidget::List &dockWidgets,
                          const Core::MainWindow::List &mainWindows,
                          const Vector<QString> &affinities)
 {
+    KDDW_TRACE_SCOPE("DockRegistry::clear");
     for (auto dw : std::as_const(dockWidgets)) {
         if (affinities.isEmpty() || affinitiesMatch(affinities, dw->affinities())) {
             dw->forceClose();
@@ -713,8 +788,8 @@ bool DockRegistry::onMouseButtonPress(View *view, MouseEvent *event)
     // When clicking on a MDI Frame we raise the window
     if (Controller *c = view->d->firstParentOfType(ViewType::Frame)) {
         auto group = static_cast<Group *>(c);
-        if (group->isMDI())
-            group->view()->raise();
+        if (MDILayout *layout = group->mdiLayout())
+            layout->raiseGroup(group);
     }
 
     // The following code is for hididng the overlay
@@ -779,12 +854,18 @@ bool DockRegistry::onDockWidgetPressed(Core::DockWidget *dw, MouseEvent *ev)
     return false;
 }
 
+EventFilterInterface::EventTypes DockRegistry::eventTypes() const
+{
+    return EventType_Expose | EventType_MouseButtonPress;
+}
+
 bool DockRegistry::onExposeEvent(Core::Window::Ptr window)
 {
     if (Core::FloatingWindow *fw = floatingWindowForHandle(window)) {
         // This floating window was exposed
         m_floatingWindows.removeOne(fw);
         m_floatingWindows.append(fw);
+        d->m_topLevelsGeneration++;
     }
 
     return false;
@@ -39,6 +39,8 @@ class Group;
 class MainWindowMDIViewInterface;
 class MainWindowViewInterface;
 class FocusScope;
+class GroupPool;
+class FloatingWindowPool;
 struct WindowBeingDragged;
 }
 
@@ -116,6 +118,14 @@ public:
     ///@brief returns a list of all Frame instances
     Vector<Core::Group *> groups() const;
 
+    /// Returns the emptied groups kept for reuse. Pooled groups aren't in groups().
+    /// See Config::setGroupPoolSize().
+    Core::GroupPool *groupPool() const;
+
+    /// Returns the hidden floating windows kept ready for tearing off. Pooled windows aren't in
+    /// floatingWindows(). See Config::setFloatingWindowPoolSize().
+    Core::FloatingWindowPool *floatingWindowPool() const;
+
     ///@brief returns all FloatingWindow instances. Not necessarily all floating dock widgets,
     /// As there might be DockWidgets which weren't morphed yet.
     Vector<Core::FloatingWindow *>
@@ -247,6 +257,7 @@ private:
     void setFocusedDockWidget(Core::DockWidget *);
 
     // EventFilterInterface:
+    EventTypes eventTypes() const override;
     bool onExposeEvent(std::shared_ptr<Core::Window>) override;
     bool onMouseButtonPress(Core::View *, MouseEvent *) override;
 
@@ -14,11 +14,17 @@
 
 #include <kdbindings/signal.h>
 
+#include <cstdint>
+#include <unordered_map>
+
 
 #pragma once
 
 // Pimpl class so we can keep kdbindings private
 
+#include "GroupPool_p.h"
+#include "FloatingWindowPool_p.h"
+
 namespace KDDockWidgets {
 
 class DockRegistry::Private
@@ -39,6 +45,29 @@ public:
     KDBindings::ConnectionHandle m_connection;
 
     int m_numLayoutSavers = 0;
+
+    /// Indexes DockRegistry::m_dockWidgets and m_mainWindows by unique name, so lookups are O(1).
+    /// Unique names can't change after registration.
+    std::unordered_map<QString, Core::DockWidget *> m_dockWidgetsByName;
+    std::unordered_map<QString, Core::MainWindow *> m_mainWindowsByName;
+
+    /// Floating windows by native handle.
+    /// Filled on lookup, as native windows are created lazily.
+    mutable std::unordered_map<Core::WId, Core::FloatingWindow *> m_floatingWindowsByHandle;
+
+    /// Bumped whenever a main window or floating window is added, removed or raised.
+    /// Lets DragController know when its cached z-order is stale.
+    /// Starts at 1, so caches can use 0 for "never computed".
+    uint64_t m_topLevelsGeneration = 1;
+
+    /// See Config::setGroupPoolSize(). Mutable, as it's handed out by groupPool() const.
+    mutable Core::GroupPool m_groupPool;
+
+    /// See Config::setFloatingWindowPoolSize()
+    mutable Core::FloatingWindowPool m_floatingWindowPool;
+
+    /// Deleting the pools unregisters windows, which mustn't delete us again
+    bool m_inDtor = false;
 };
 
 }
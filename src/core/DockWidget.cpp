@@ -12,6 +12,7 @@
 #include "DockWidget.h"
 #include "DockWidget_p.h"
 #include "DockRegistry.h"
+#include "core/JsonWriter_p.h"
 #include "core/LayoutSaver_p.h"
 #include "core/Logging_p.h"
 #include "core/MDILayout.h"
@@ -449,8 +450,8 @@ void DockWidget::raise()
         fw->view()->raise();
         fw->view()->activateWindow();
     } else if (Core::Group *group = d->group()) {
-        if (group->isMDI())
-            group->view()->raise();
+        if (MDILayout *layout = group->mdiLayout())
+            layout->raiseGroup(group);
     }
 }
 
@@ -589,12 +590,12 @@ Core::FloatingWindow *DockWidget::Private::morphIntoFloatingWindow()
             }
         }
 
-        auto group = new Core::Group();
+        auto group = Core::Group::create();
         group->addTab(q);
         geo.setSize(geo.size().boundedTo(group->view()->maxSizeHint()));
         geo.setSize(geo.size().expandedTo(group->view()->minSize()));
         Core::FloatingWindow::ensureRectIsOnScreen(geo);
-        auto floatingWindow = new Core::FloatingWindow(group, geo);
+        auto floatingWindow = Core::FloatingWindow::create(group, geo);
 
         Core::AtomicSanityChecks checks(floatingWindow->dropArea()->rootItem());
         floatingWindow->view()->show();
@@ -970,6 +971,20 @@ LayoutSaver::DockWidget::Ptr DockWidget::Private::serialize() const
     return ptr;
 }
 
+void DockWidget::Private::serialize(JsonWriter &writer) const
+{
+    writer.beginObject();
+    if (!affinities.isEmpty()) {
+        writer.key("affinities");
+        writer.value(affinities);
+    }
+    writer.key("lastPosition");
+    m_lastPosition->serialize(writer);
+    writer.key("uniqueName");
+    writer.value(q->uniqueName());
+    writer.endObject();
+}
+
 void DockWidget::Private::forceClose()
 {
     ScopedValueRollback rollback(m_isForceClosing, true);
@@ -1016,6 +1031,11 @@ DockWidget::Private::Private(const QString &dockName, DockWidgetOptions options_
             }
         }
     });
+
+    m_isCurrentTabConnection = isCurrentTabChanged.connect([this](bool isCurrent) {
+        if (isCurrent)
+            maybeCreateGuestView();
+    });
 }
 
 void DockWidget::Private::addPlaceholderItem(Core::Item *item)
@@ -1098,6 +1118,24 @@ void DockWidget::Private::setIsOpen(bool is)
     }
 
     isOpenChanged.emit(is);
+
+    if (is)
+        maybeCreateGuestView();
+}
+
+void DockWidget::Private::maybeCreateGuestView()
+{
+    // While restoring, background tabs are temporarily current. LayoutSaver calls us again
+    // when it's done.
+    if (guest || m_creatingGuestView || LayoutSaver::restoreInProgress())
+        return;
+
+    GuestViewFactoryFunc func = Config::self().guestViewFactoryFunc();
+    if (!func || !q->isOpen() || !q->isCurrentTab())
+        return;
+
+    ScopedValueRollback guard(m_creatingGuestView, true);
+    func(q);
 }
 
 void DockWidget::setFloatingWindowFlags(FloatingWindowFlags flags)
@@ -22,6 +22,7 @@
 namespace KDDockWidgets {
 
 namespace Core {
+class JsonWriter;
 class SideBar;
 
 class DOCKS_EXPORT_FOR_UNIT_TESTS DockWidget::Private
@@ -122,11 +123,17 @@ public:
     void onCloseEvent(CloseEvent *);
     void onParentChanged();
 
+    /// Calls Config::guestViewFactoryFunc() if we don't have a guest view yet and are visible
+    void maybeCreateGuestView();
+
     /**
      * @brief Serializes this dock widget into an intermediate form
      */
     std::shared_ptr<LayoutSaver::DockWidget> serialize() const;
 
+    /// Writes this dock widget's entry of LayoutSaver's "allDockWidgets"
+    void serialize(JsonWriter &) const;
+
     /**
      * @brief the Group which contains this dock widgets.
      *
@@ -269,6 +276,7 @@ public:
     bool m_inClose = false;
     bool m_removingFromOverlay = false;
     bool m_wasRestored = false;
+    bool m_creatingGuestView = false;
     Size m_lastOverlayedSize = Size(0, 0);
     int m_userType = 0;
     bool m_willUpdateActions = false;
@@ -276,6 +284,7 @@ public:
     KDBindings::ScopedConnection m_windowDeactivatedConnection;
     KDBindings::ScopedConnection m_toggleActionConnection;
     KDBindings::ScopedConnection m_floatActionConnection;
+    KDBindings::ScopedConnection m_isCurrentTabConnection;
 };
 
 }
@@ -14,18 +14,23 @@
 #include "Utils_p.h"
 #include "WidgetResizeHandler_p.h"
 #include "Config.h"
+#include "DelayedCall_p.h"
 #include "WindowZOrder_x11_p.h"
 
 #include "core/DockRegistry.h"
+#include "core/DockRegistry_p.h"
 #include "core/Window_p.h"
+#include "core/MainWindow.h"
 #include "core/MDILayout.h"
 #include "core/DropArea.h"
+#include "core/DropIndicatorOverlay_p.h"
 #include "core/TitleBar.h"
 #include "core/Platform.h"
 #include "core/Group.h"
 #include "core/FloatingWindow.h"
 #include "core/DockWidget_p.h"
 #include "core/ScopedValueRollback_p.h"
+#include "core/Tracing_p.h"
 
 #ifdef KDDW_FRONTEND_QT
 #include "../qtcommon/DragControllerWayland_p.h"
@@ -79,6 +84,11 @@ public:
         Platform::instance()->removeGlobalEventFilter(this);
     }
 
+    EventTypes eventTypes() const override
+    {
+        return EventType_Mouse;
+    }
+
     bool onMouseEvent(View *, MouseEvent *me) override
     {
         if (m_reentrancyGuard || !m_guard)
@@ -136,6 +146,7 @@ State *MinimalStateMachine::currentState() const
 
 void MinimalStateMachine::setCurrentState(State *state)
 {
+    KDDW_TRACE_SCOPE("DragController::setCurrentState");
     if (state != m_currentState) {
         if (m_currentState)
             m_currentState->onExit();
@@ -169,6 +180,7 @@ StateNone::StateNone(DragController *parent)
 
 void StateNone::onEntry()
 {
+    KDDW_TRACE_SCOPE("DragController::StateNone::onEntry");
     KDDW_DEBUG("StateNone entered");
     q->m_pressPos = Point();
     q->m_offset = Point();
@@ -226,6 +238,7 @@ StatePreDrag::~StatePreDrag() = default;
 
 void StatePreDrag::onEntry()
 {
+    KDDW_TRACE_SCOPE("DragController::StatePreDrag::onEntry");
     KDDW_DEBUG("StatePreDrag entered {}", q->m_draggableGuard.isNull());
     WidgetResizeHandler::s_disableAllHandlers = true; // Disable the resize handler during dragging
 }
@@ -291,12 +304,44 @@ StateDragging::StateDragging(DragController *parent)
 
 StateDragging::~StateDragging() = default;
 
+namespace {
+
+/// With Config::Flag_CoalesceDragHover, hovers are processed at most once per this interval.
+/// We don't know the display's refresh rate here, so assume 60Hz.
+constexpr int s_hoverIntervalMs = 16;
+
+class DelayedHover : public DelayedCall
+{
+public:
+    explicit DelayedHover(StateDragging *state)
+        : m_state(state)
+    {
+    }
+
+    void call() override
+    {
+        if (m_state)
+            m_state->flushPendingHover();
+    }
+
+    KDDW_DELETE_COPY_CTOR(DelayedHover)
+
+private:
+    ObjectGuard<StateDragging> m_state;
+};
+
+}
+
 void StateDragging::onEntry()
 {
+    KDDW_TRACE_SCOPE("DragController::StateDragging::onEntry");
 #if defined(KDDW_FRONTEND_QT_WINDOWS) && !defined(DOCKS_DEVELOPER_MODE)
     m_maybeCancelDrag.start();
 #endif
 
+    q->resetHoverStats();
+    m_hoverPending = false;
+
     if (!q->m_draggableGuard) {
         KDDW_ERROR("Draggable was destroyed, canceling the drag");
         q->dragCanceled.emit();
@@ -342,6 +387,7 @@ void StateDragging::onEntry()
         KDDW_DEBUG("StateDragging entered. m_draggable={}; m_windowBeingDragged={}", ( void * )q->m_draggable, ( void * )q->m_windowBeingDragged->floatingWindow());
 
         auto fw = q->m_windowBeingDragged->floatingWindow();
+        q->clearTopLevelsCache();
 #ifdef Q_OS_LINUX
         if (fw->view()->isMaximized()) {
             // When dragging a maximized window on linux we need to restore its normal size
@@ -394,10 +440,15 @@ void StateDragging::onEntry()
 
 void StateDragging::onExit()
 {
+    KDDW_TRACE_SCOPE("DragController::StateDragging::onExit");
 #if defined(KDDW_FRONTEND_QT_WINDOWS) && !defined(DOCKS_DEVELOPER_MODE)
     m_maybeCancelDrag.stop();
 #endif
 
+    // Don't hold on to the windows
+    q->clearTopLevelsCache();
+    m_hoverPending = false;
+
     if (auto callback = Config::self().dragEndedFunc()) {
         // this user is interested in knowing the drag ended
         callback();
@@ -406,6 +457,7 @@ void StateDragging::onExit()
 
 bool StateDragging::handleMouseButtonRelease(Point globalPos)
 {
+    KDDW_TRACE_SCOPE("DragController::StateDragging::handleMouseButtonRelease");
     KDDW_DEBUG("StateDragging: handleMouseButtonRelease");
 
     FloatingWindow *floatingWindow = q->m_windowBeingDragged->floatingWindow();
@@ -422,6 +474,12 @@ bool StateDragging::handleMouseButtonRelease(Point globalPos)
         return true;
     }
 
+    if (m_hoverPending) {
+        // Make sure we drop where the indicators say, not where they were a frame ago
+        m_pendingHoverPos = globalPos;
+        flushPendingHover();
+    }
+
     if (q->m_currentDropArea) {
         if (q->m_currentDropArea->drop(q->m_windowBeingDragged.get(), globalPos)) {
             q->dropped.emit();
@@ -438,6 +496,7 @@ bool StateDragging::handleMouseButtonRelease(Point globalPos)
 
 bool StateDragging::handleMouseMove(Point globalPos)
 {
+    KDDW_TRACE_SCOPE("DragController::StateDragging::handleMouseMove");
     FloatingWindow *fw = q->m_windowBeingDragged->floatingWindow();
     if (!fw) {
         KDDW_DEBUG("Canceling drag, window was deleted");
@@ -472,6 +531,44 @@ bool StateDragging::handleMouseMove(Point globalPos)
         return true;
     }
 
+    q->m_hoverStats.mouseMoves++;
+
+    if (Config::hasFlag(Config::Flag_CoalesceDragHover)) {
+        // The window already moved, but the drop indicators only need updating once per frame
+        m_pendingHoverPos = globalPos;
+        if (m_hoverPending) {
+            q->m_hoverStats.hoversCoalesced++;
+        } else {
+            m_hoverPending = true;
+            Platform::instance()->runDelayed(s_hoverIntervalMs, new DelayedHover(this));
+        }
+        return true;
+    }
+
+    return updateHover(globalPos);
+}
+
+void StateDragging::flushPendingHover()
+{
+    if (!m_hoverPending)
+        return;
+
+    m_hoverPending = false;
+    if (!isActiveState())
+        return;
+
+    FloatingWindow *fw = q->m_windowBeingDragged ? q->m_windowBeingDragged->floatingWindow() : nullptr;
+    if (!fw || fw->beingDeleted())
+        return;
+
+    updateHover(m_pendingHoverPos);
+}
+
+bool StateDragging::updateHover(Point globalPos)
+{
+    KDDW_TRACE_SCOPE("DragController::StateDragging::updateHover");
+    q->m_hoverStats.hoversComputed++;
+
     DropArea *dropArea = q->dropAreaUnderCursor();
     if (q->m_currentDropArea && dropArea != q->m_currentDropArea)
         q->m_currentDropArea->removeHover();
@@ -484,7 +581,11 @@ bool StateDragging::handleMouseMove(Point globalPos)
             }
         }
 
+        DropIndicatorOverlay *overlay = dropArea->dropIndicatorOverlay();
+        const int skippedBefore = overlay ? overlay->dptr()->skippedHovers : 0;
         dropArea->hover(q->m_windowBeingDragged.get(), globalPos);
+        if (overlay && overlay->dptr()->skippedHovers != skippedBefore)
+            q->m_hoverStats.hoversSkipped++;
     }
 
     q->m_currentDropArea = dropArea;
@@ -511,6 +612,7 @@ StateInternalMDIDragging::~StateInternalMDIDragging()
 
 void StateInternalMDIDragging::onEntry()
 {
+    KDDW_TRACE_SCOPE("DragController::StateInternalMDIDragging::onEntry");
     KDDW_DEBUG("StateInternalMDIDragging entered. draggable={}", ( void * )q->m_draggable);
 
     if (!q->m_draggableGuard) {
@@ -521,8 +623,12 @@ void StateInternalMDIDragging::onEntry()
 
     // Raise the dock widget being dragged
     if (auto tb = q->m_draggable->asView()->asTitleBarController()) {
-        if (Group *f = tb->group())
-            f->view()->raise();
+        if (Group *f = tb->group()) {
+            if (MDILayout *layout = f->mdiLayout())
+                layout->raiseGroup(f);
+            else
+                f->view()->raise();
+        }
     }
 
     q->isDraggingChanged.emit();
@@ -536,6 +642,7 @@ bool StateInternalMDIDragging::handleMouseButtonRelease(Point)
 
 bool StateInternalMDIDragging::handleMouseMove(Point globalPos)
 {
+    KDDW_TRACE_SCOPE("DragController::StateInternalMDIDragging::handleMouseMove");
     if (!q->m_draggableGuard) {
         KDDW_ERROR("Draggable was destroyed, canceling the drag");
         q->dragCanceled.emit();
@@ -707,11 +814,26 @@ void DragController::enableFallbackMouseGrabber()
         m_fallbackMouseGrabber = new FallbackMouseGrabber(this);
 }
 
+DragController::HoverStats DragController::hoverStats() const
+{
+    return m_hoverStats;
+}
+
+void DragController::resetHoverStats()
+{
+    m_hoverStats = {};
+}
+
 WindowBeingDragged *DragController::windowBeingDragged() const
 {
     return m_windowBeingDragged.get();
 }
 
+EventFilterInterface::EventTypes DragController::eventTypes() const
+{
+    return EventType_Mouse | EventType_DnD | EventType_Move;
+}
+
 bool DragController::onDnDEvent(View *view, Event *e)
 {
     if (!isWayland())
@@ -950,6 +1072,46 @@ static std::shared_ptr<View> qtTopLevelUnderCursor_impl(Point globalPos,
     return nullptr;
 }
 
+const Vector<DragController::TopLevel> &DragController::topLevelsByZOrder() const
+{
+    const uint64_t generation = DockRegistry::self()->dptr()->m_topLevelsGeneration;
+    if (generation == m_topLevelsGeneration)
+        return m_topLevelsByZOrder;
+
+    m_topLevelsGeneration = generation;
+    m_topLevelsByZOrder.clear();
+
+    // On Linux we don't have API to check the z-order of top-levels. So floating windows go last
+    // and main windows first, as the main window will have lower z-order as it's a parent.
+    // The floating window list is sorted by z-order, as we catch QEvent::Expose and move it to
+    // last of the list.
+    // Visibility is checked when hit-testing, as it can change during the drag.
+    const auto mainWindows = DockRegistry::self()->mainwindows();
+    const auto floatingWindows = DockRegistry::self()->floatingWindows();
+    m_topLevelsByZOrder.reserve(mainWindows.size() + floatingWindows.size());
+
+    for (MainWindow *mw : mainWindows) {
+        if (Window::Ptr window = mw->view()->window())
+            m_topLevelsByZOrder.push_back({ window, window->rootView() });
+    }
+
+    FloatingWindow *fwBeingDragged = floatingWindowBeingDragged();
+    for (FloatingWindow *fw : floatingWindows) {
+        if (fw == fwBeingDragged)
+            continue;
+        if (Window::Ptr window = fw->view()->window())
+            m_topLevelsByZOrder.push_back({ window, window->rootView(), fw });
+    }
+
+    return m_topLevelsByZOrder;
+}
+
+void DragController::clearTopLevelsCache()
+{
+    m_topLevelsByZOrder.clear();
+    m_topLevelsGeneration = 0;
+}
+
 std::shared_ptr<View> DragController::qtTopLevelUnderCursor() const
 {
     Point globalPos = Platform::instance()->cursorPos();
@@ -1019,19 +1181,26 @@ std::shared_ptr<View> DragController::qtTopLevelUnderCursor() const
         }
     } else {
         // !Windows: Linux, macOS, offscreen (offscreen on Windows too), etc.
-
-        // On Linux we don't have API to check the z-order of top-levels. So first check the
-        // floating windows and check the MainWindow last, as the MainWindow will have lower z-order
-        // as it's a parent (TODO: How will it work with multiple MainWindows ?) The floating window
-        // list is sorted by z-order, as we catch QEvent::Expose and move it to last of the list
+        // (TODO: How will it work with multiple MainWindows ?)
 
         View *tlwBeingDragged = m_windowBeingDragged->floatingWindow()->view();
-        if (auto tl = qtTopLevelUnderCursor_impl(
-                globalPos, DockRegistry::self()->floatingQWindows(), tlwBeingDragged))
-            return tl;
+        const Vector<TopLevel> &topLevels = topLevelsByZOrder();
+        for (auto i = topLevels.size() - 1; i >= 0; --i) {
+            const TopLevel &topLevel = topLevels.at(i);
+            View *tl = topLevel.rootView.get();
+            if (!tl || !tl->isVisible() || tl->equals(tlwBeingDragged) || tl->isMinimized())
+                continue;
 
-        return qtTopLevelUnderCursor_impl(
-            globalPos, DockRegistry::self()->topLevels(/*excludeFloatingDocks=*/true), tlwBeingDragged);
+            // Windows scheduled for deletion stay registered until they're gone, so they
+            // don't bump the generation. Check here instead of when building the cache.
+            if (topLevel.floatingWindow && topLevel.floatingWindow->beingDeleted())
+                continue;
+
+            if (topLevel.window->geometry().contains(globalPos)) {
+                KDDW_TRACE("Found top-level {}", ( void * )tl);
+                return topLevel.rootView;
+            }
+        }
     }
 
     KDDW_TRACE("No top-level found");
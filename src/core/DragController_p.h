@@ -20,6 +20,7 @@
 
 #include <kdbindings/signal.h>
 
+#include <cstdint>
 #include <memory>
 
 #ifdef KDDW_FRONTEND_QT_WINDOWS
@@ -143,6 +144,18 @@ public:
     /// Wayland only
     bool isInQDrag() const;
 
+    /// Counters about hover processing while dragging. Reset when a drag starts.
+    /// See Config::Flag_CoalesceDragHover
+    struct HoverStats
+    {
+        int mouseMoves = 0; ///< Mouse moves received while dragging
+        int hoversComputed = 0; ///< Times the drop area under the cursor was resolved and hovered
+        int hoversCoalesced = 0; ///< Mouse moves folded into an already scheduled hover
+        int hoversSkipped = 0; ///< Hovers that didn't update the indicators, as the drop location didn't change
+    };
+    HoverStats hoverStats() const;
+    void resetHoverStats();
+
 private:
     friend class StateBase;
     friend class StateNone;
@@ -154,7 +167,23 @@ private:
 
     explicit DragController(Core::Object * = nullptr);
     std::shared_ptr<Core::View> qtTopLevelUnderCursor() const;
+
+    /// A top-level we can drop into. See topLevelsByZOrder()
+    struct TopLevel
+    {
+        std::shared_ptr<Core::Window> window;
+        std::shared_ptr<Core::View> rootView;
+        Core::FloatingWindow *floatingWindow = nullptr; ///< nullptr for main windows
+    };
+
+    /// Returns the floating windows and main windows sorted by z-order, top-most last.
+    /// Cached while dragging, so hit-testing doesn't have to query and allocate them on each mouse
+    /// move. Only used on platforms where we can't ask the window system for the z-order.
+    const Vector<TopLevel> &topLevelsByZOrder() const;
+    void clearTopLevelsCache();
+
     Core::Draggable *draggableForView(Core::View *) const;
+    EventTypes eventTypes() const override;
     bool onDnDEvent(Core::View *, Event *) override;
     bool onMoveEvent(Core::View *) override;
     bool onMouseEvent(Core::View *, MouseEvent *) override;
@@ -176,6 +205,10 @@ private:
     bool m_nonClientDrag = false; // native title bar drag
     bool m_inQDrag = false; // wayland drag
     bool m_inProgrammaticDrag = false; // via DockWidget::startDrag()
+
+    mutable Vector<TopLevel> m_topLevelsByZOrder;
+    mutable uint64_t m_topLevelsGeneration = 0; // See DockRegistry::Private::m_topLevelsGeneration
+    HoverStats m_hoverStats;
 };
 
 class StateBase : public State
@@ -263,8 +296,18 @@ public:
     bool handleMouseMove(Point globalPos) override;
     bool handleMouseDoubleClick() override;
 
-#if defined(KDDW_FRONTEND_QT_WINDOWS)
+    /// Processes the hover that handleMouseMove() postponed, if any.
+    /// Only used with Config::Flag_CoalesceDragHover
+    void flushPendingHover();
+
 private:
+    /// Resolves the drop area under the cursor and updates its drop indicators
+    bool updateHover(Point globalPos);
+
+    Point m_pendingHoverPos;
+    bool m_hoverPending = false;
+
+#if defined(KDDW_FRONTEND_QT_WINDOWS)
     QTimer m_maybeCancelDrag;
 #endif
 };
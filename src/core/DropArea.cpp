@@ -17,6 +17,7 @@
 #include "Platform.h"
 #include "core/Draggable_p.h"
 #include "core/Logging_p.h"
+#include "core/Tracing_p.h"
 #include "core/Utils_p.h"
 #include "core/layouting/Item_p.h"
 #include "core/layouting/LayoutingGuest_p.h"
@@ -74,6 +75,20 @@ public:
     Core::Group *const m_centralFrame = nullptr;
     Core::ItemBoxContainer *m_rootItem = nullptr;
     KDBindings::ScopedConnection m_visibleWidgetCountConnection;
+
+    /// Caches rectForDrop() results while a window is dragged over us, as the overlay asks
+    /// for the same rects over and over. Cleared when the layout changes or the hover ends.
+    struct DropRectCacheEntry
+    {
+        const Core::Item *relativeTo = nullptr;
+        Location location = Location_None;
+        Size size;
+        Size minSize;
+        Size maxSize;
+        Rect rect;
+    };
+    mutable Vector<DropRectCacheEntry> m_dropRectCache;
+    mutable uint64_t m_dropRectCacheGeneration = 0;
 };
 }
 
@@ -127,35 +142,28 @@ DropArea::~DropArea()
 
 Core::Group::List DropArea::groups() const
 {
-    const Core::Item::List children = d->m_rootItem->items_recursive();
     Core::Group::List groups;
-
-    for (const Core::Item *child : children) {
-        if (auto guest = child->guest()) {
-            if (!guest->freed()) {
-                if (auto group = Group::fromItem(child)) {
-                    groups.push_back(group);
-                }
-            }
-        }
-    }
+    visitGroups([&groups](Core::Group *group) {
+        groups.push_back(group);
+    });
 
     return groups;
 }
 
 Core::Group *DropArea::groupContainingPos(Point globalPos) const
 {
-    const Core::Item::List &items = this->items();
-    for (Core::Item *item : items) {
-        auto group = Group::fromItem(item);
-        if (!group || !group->isVisible()) {
-            continue;
-        }
+    // Called for every mouse move while dragging. Descends the layout instead of testing every
+    // group, and doesn't allocate.
+    auto root = rootItem()->asBoxContainer();
+    if (!root)
+        return nullptr;
 
-        if (group->containsMouse(globalPos))
-            return group;
-    }
-    return nullptr;
+    Core::Item *item = root->itemAt_recursive(root->mapFromRoot(view()->mapFromGlobal(globalPos)));
+    auto group = Group::fromItem(item);
+    if (!group || !group->isVisible())
+        return nullptr;
+
+    return group;
 }
 
 void DropArea::updateFloatingActions()
@@ -167,14 +175,17 @@ void DropArea::updateFloatingActions()
 
 Core::Item *DropArea::centralFrame() const
 {
-    const auto items = this->items();
-    for (Core::Item *item : items) {
-        if (auto group = Group::fromItem(item)) {
-            if (group->isCentralFrame())
-                return item;
-        }
-    }
-    return nullptr;
+    Core::Item *result = nullptr;
+    d->m_rootItem->visit_recursive([&result](Core::Item *item) {
+        auto group = Group::fromItem(item);
+        if (!group || !group->isCentralFrame())
+            return true;
+
+        result = item;
+        return false;
+    });
+
+    return result;
 }
 
 DropIndicatorOverlay *DropArea::dropIndicatorOverlay() const
@@ -217,11 +228,11 @@ void DropArea::addDockWidget(Core::DockWidget *dw, Location location,
             // the group instead
             group = oldFrame;
         } else {
-            group = new Core::Group();
+            group = Core::Group::create();
             group->addTab(dw);
         }
     } else {
-        group = new Core::Group();
+        group = Core::Group::create();
         group->addTab(dw);
     }
 
@@ -245,8 +256,15 @@ bool DropArea::containsDockWidget(Core::DockWidget *dw) const
 
 bool DropArea::hasSingleFloatingFrame() const
 {
-    const Core::Group::List groups = this->groups();
-    return groups.size() == 1 && groups.first()->isFloating();
+    int numGroups = 0;
+    bool isFloating = false;
+    visitGroups([&numGroups, &isFloating](Core::Group *group) {
+        ++numGroups;
+        isFloating = group->isFloating();
+        return numGroups < 2;
+    });
+
+    return numGroups == 1 && isFloating;
 }
 
 bool DropArea::hasSingleFrame() const
@@ -278,6 +296,7 @@ void DropArea::layoutParentContainerEqually(Core::DockWidget *dw)
 
 DropLocation DropArea::hover(WindowBeingDragged *draggedWindow, Point globalPos)
 {
+    KDDW_TRACE_SCOPE("DropArea::hover");
     if (Config::self().dropIndicatorsInhibited() || !validateAffinity(draggedWindow))
         return DropLocation_None;
 
@@ -310,6 +329,7 @@ static bool isOutterLocation(DropLocation location)
 
 bool DropArea::drop(WindowBeingDragged *droppedWindow, Point globalPos)
 {
+    KDDW_TRACE_SCOPE("DropArea::drop");
     // fv might be null, if on wayland
     Core::View *fv = droppedWindow->floatingWindowView();
 
@@ -431,7 +451,7 @@ bool DropArea::drop(View *droppedWindow, KDDockWidgets::Location location,
         if (!validateAffinity(dock))
             return false;
 
-        auto group = new Core::Group();
+        auto group = Core::Group::create();
         group->addTab(dock);
         addWidget(group->view(), location, relativeTo, DefaultSizeMode::FairButFloor);
     } else if (auto floatingWindow = droppedWindow->asFloatingWindowController()) {
@@ -454,6 +474,7 @@ bool DropArea::drop(View *droppedWindow, KDDockWidgets::Location location,
 void DropArea::removeHover()
 {
     d->m_dropIndicatorOverlay->removeHover();
+    d->m_dropRectCache.clear();
 }
 
 template<typename T>
@@ -504,7 +525,7 @@ Core::Group *DropArea::createCentralFrame(MainWindowOptions options)
             groupOptions |= FrameOption_AlwaysShowsTabs;
         }
 
-        group = new Core::Group(nullptr, groupOptions);
+        group = Core::Group::create(nullptr, groupOptions);
         group->setObjectName(QStringLiteral("central group"));
     }
 
@@ -594,7 +615,7 @@ void DropArea::addWidget(View *w, Location location, Core::Group *relativeToWidg
         newItem->setGuest(group->asLayoutingGuest());
     } else if (dw) {
         newItem = new Core::Item(asLayoutingHost());
-        group = new Core::Group();
+        group = Core::Group::create();
         newItem->setGuest(group->asLayoutingGuest());
         group->addTab(dw, option);
     } else if (auto ms = w->asDropAreaController()) {
@@ -614,7 +635,12 @@ void DropArea::addWidget(View *w, Location location, Core::Group *relativeToWidg
     }
 
     assert(!newItem->geometry().isEmpty());
-    Core::ItemBoxContainer::insertItemRelativeTo(newItem, relativeTo, location, option);
+    {
+        // Inserting can convert items into containers and simplify the tree, only update
+        // separators and guests once
+        Core::LayoutTransaction transaction(d->m_rootItem);
+        Core::ItemBoxContainer::insertItemRelativeTo(newItem, relativeTo, location, option);
+    }
 
     if (dw && option.startsHidden())
         delete group;
@@ -681,18 +707,42 @@ Core::ItemBoxContainer *DropArea::rootItem() const
 Rect DropArea::rectForDrop(const WindowBeingDragged *wbd, Location location,
                            const Core::Item *relativeTo) const
 {
-    Core::Item item(nullptr);
     if (!wbd)
         return {};
 
-    item.setSize(wbd->size().boundedTo(wbd->maxSize()));
-    item.setMinSize(wbd->minSize());
-    item.setMaxSizeHint(wbd->maxSize());
+    const Size size = wbd->size();
+    const Size minSize = wbd->minSize();
+    const Size maxSize = wbd->maxSize();
+
+    if (d->m_dropRectCacheGeneration != Core::Item::layoutGeneration()) {
+        d->m_dropRectCache.clear();
+    } else {
+        for (const auto &entry : std::as_const(d->m_dropRectCache)) {
+            if (entry.relativeTo == relativeTo && entry.location == location
+                && entry.size == size && entry.minSize == minSize && entry.maxSize == maxSize)
+                return entry.rect;
+        }
+    }
+
+    Rect rect;
+    {
+        Core::Item item(nullptr);
+        item.setSize(size.boundedTo(maxSize));
+        item.setMinSize(minSize);
+        item.setMaxSizeHint(maxSize);
+
+        Core::ItemBoxContainer *container =
+            relativeTo ? relativeTo->parentBoxContainer() : d->m_rootItem;
+
+        rect = container->suggestedDropRect(&item, relativeTo, location);
+    }
 
-    Core::ItemBoxContainer *container =
-        relativeTo ? relativeTo->parentBoxContainer() : d->m_rootItem;
+    // suggestedDropRect() works on a throw-away copy of the layout, which also bumps the
+    // generation, so only read it now
+    d->m_dropRectCacheGeneration = Core::Item::layoutGeneration();
+    d->m_dropRectCache.push_back({ relativeTo, location, size, minSize, maxSize, rect });
 
-    return container->suggestedDropRect(&item, relativeTo, location);
+    return rect;
 }
 
 bool DropArea::deserialize(const LayoutSaver::MultiSplitter &l)
@@ -68,6 +68,7 @@ void DropIndicatorOverlay::setWindowBeingDragged(bool is)
         return;
 
     m_draggedWindowIsHovering = is;
+    d->dropLocationDirty = true;
     if (is) {
         view()->setGeometry(m_dropArea->rect());
         view()->raise();
@@ -103,6 +104,7 @@ void DropIndicatorOverlay::setHoveredGroup(Core::Group *group)
         d->groupConnection = KDBindings::ScopedConnection();
 
     m_hoveredGroup = group;
+    d->dropLocationDirty = true;
     if (m_hoveredGroup) {
         d->groupConnection = group->Controller::dptr()->aboutToBeDeleted.connect([this] { onGroupDestroyed(); });
         setHoveredGroupRect(m_hoveredGroup->view()->geometry());
@@ -229,6 +231,14 @@ void DropIndicatorOverlay::setCurrentDropLocation(DropLocation location)
 DropLocation DropIndicatorOverlay::hover(Point globalPos)
 {
     const DropLocation loc = hover_impl(globalPos);
+    if (loc == m_currentDropLocation && !d->dropLocationDirty
+        && Config::hasFlag(Config::Flag_CoalesceDragHover)) {
+        // Still over the same drop segment of the same group, the rubber band didn't change
+        d->skippedHovers++;
+        return loc;
+    }
+
+    d->dropLocationDirty = false;
     setCurrentDropLocation(loc);
     return loc;
 }
@@ -237,6 +247,7 @@ void DropIndicatorOverlay::setHoveredGroupRect(Rect rect)
 {
     if (m_hoveredGroupRect != rect) {
         m_hoveredGroupRect = rect;
+        d->dropLocationDirty = true;
         d->hoveredGroupRectChanged.emit();
     }
 }
@@ -32,6 +32,14 @@ public:
     KDBindings::Signal<> currentDropLocationChanged;
     KDBindings::ScopedConnection groupConnection;
     KDBindings::ScopedConnection dropIndicatorsInhibitedConnection;
+
+    /// Whether the next hover needs to apply the drop location even if it didn't change.
+    /// Set when the hovered group or its geometry changes, as the rubber band depends on them.
+    bool dropLocationDirty = true;
+
+    /// Number of hovers that kept the current drop location without re-applying it.
+    /// Only with Config::Flag_CoalesceDragHover. DragController reads it for its hover stats.
+    int skippedHovers = 0;
 };
 
 }
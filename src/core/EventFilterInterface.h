@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "kddockwidgets/docks_export.h"
 #include "../QtCompat_p.h"
 
 #include <memory>
@@ -22,12 +23,36 @@ namespace Core {
 class Window;
 class View;
 
-class EventFilterInterface
+class DOCKS_EXPORT EventFilterInterface
 {
 public:
+    /// @brief The kinds of events a filter can handle, see eventTypes()
+    enum EventType {
+        EventType_None = 0,
+        EventType_Expose = 1, ///< onExposeEvent()
+        EventType_MouseButtonPress = 2, ///< onMouseButtonPress() and onMouseEvent()
+        EventType_MouseButtonRelease = 4, ///< onMouseButtonRelease() and onMouseEvent()
+        EventType_MouseMove = 8, ///< onMouseButtonMove() and onMouseEvent()
+        EventType_MouseDoubleClick = 16, ///< onMouseDoubleClick() and onMouseEvent()
+        EventType_DnD = 32, ///< onDnDEvent()
+        EventType_Move = 64, ///< onMoveEvent()
+        EventType_Mouse = EventType_MouseButtonPress | EventType_MouseButtonRelease | EventType_MouseMove
+            | EventType_MouseDoubleClick,
+        EventType_All = EventType_Expose | EventType_Mouse | EventType_DnD | EventType_Move
+    };
+    Q_DECLARE_FLAGS(EventTypes, EventType)
+
     EventFilterInterface() = default;
     virtual ~EventFilterInterface();
 
+    /// @brief Override to only be offered these kinds of events
+    /// Events are dispatched through per-type lists, so filters that don't care about, say,
+    /// mouse moves don't slow them down. Queried once, when the filter is installed.
+    virtual EventTypes eventTypes() const
+    {
+        return EventType_All;
+    }
+
     /// @brief Override to handle expose events for a certain window
     virtual bool onExposeEvent(std::shared_ptr<Window>)
     {
@@ -86,3 +111,5 @@ public:
 }
 
 }
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(KDDockWidgets::Core::EventFilterInterface::EventTypes)
@@ -0,0 +1,180 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "EventFilterList_p.h"
+
+#include <algorithm>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+std::size_t EventFilterList::listIndex(EventFilterInterface::EventType type)
+{
+    switch (type) {
+    case EventFilterInterface::EventType_Expose:
+        return 0;
+    case EventFilterInterface::EventType_MouseButtonPress:
+        return 1;
+    case EventFilterInterface::EventType_MouseButtonRelease:
+        return 2;
+    case EventFilterInterface::EventType_MouseMove:
+        return 3;
+    case EventFilterInterface::EventType_MouseDoubleClick:
+        return 4;
+    case EventFilterInterface::EventType_DnD:
+        return 5;
+    case EventFilterInterface::EventType_Move:
+        return 6;
+    default:
+        break;
+    }
+
+    // Only single-bit types have a list
+    return s_numLists;
+}
+
+EventFilterInterface::EventType EventFilterList::eventTypeFor(Event::Type type)
+{
+    switch (type) {
+    case Event::MouseButtonPress:
+    case Event::NonClientAreaMouseButtonPress:
+        return EventFilterInterface::EventType_MouseButtonPress;
+    case Event::MouseButtonRelease:
+    case Event::NonClientAreaMouseButtonRelease:
+        return EventFilterInterface::EventType_MouseButtonRelease;
+    case Event::MouseMove:
+    case Event::NonClientAreaMouseMove:
+        return EventFilterInterface::EventType_MouseMove;
+    case Event::MouseButtonDblClick:
+    case Event::NonClientAreaMouseButtonDblClick:
+        return EventFilterInterface::EventType_MouseDoubleClick;
+    case Event::DragEnter:
+    case Event::DragLeave:
+    case Event::DragMove:
+    case Event::Drop:
+        return EventFilterInterface::EventType_DnD;
+    case Event::Move:
+        return EventFilterInterface::EventType_Move;
+    default:
+        break;
+    }
+
+    return EventFilterInterface::EventType_None;
+}
+
+void EventFilterList::add(EventFilterInterface *filter)
+{
+    const EventFilterInterface::EventTypes types = filter->eventTypes();
+    for (std::size_t i = 0; i < s_numLists; ++i) {
+        const auto type = EventFilterInterface::EventType(1 << i);
+        if (types.testFlag(type))
+            m_lists[listIndex(type)].push_back(filter);
+    }
+}
+
+void EventFilterList::remove(EventFilterInterface *filter)
+{
+    for (auto &list : m_lists) {
+        if (m_deliveryDepth > 0) {
+            // Can't shrink the list we're iterating. Cleaned up once delivery finishes.
+            for (EventFilterInterface *&f : list) {
+                if (f == filter) {
+                    f = nullptr;
+                    m_hasNulls = true;
+                }
+            }
+        } else {
+            list.erase(std::remove(list.begin(), list.end(), filter), list.end());
+        }
+    }
+}
+
+void EventFilterList::removeNulls()
+{
+    for (auto &list : m_lists)
+        list.erase(std::remove(list.begin(), list.end(), nullptr), list.end());
+
+    m_hasNulls = false;
+}
+
+bool EventFilterList::handles(EventFilterInterface::EventType type) const
+{
+    const std::size_t index = listIndex(type);
+    return index < s_numLists && !m_lists[index].empty();
+}
+
+template<typename Func>
+bool EventFilterList::deliver(EventFilterInterface::EventType type, Func &&func)
+{
+    const std::size_t index = listIndex(type);
+    if (index >= s_numLists || m_lists[index].empty())
+        return false;
+
+    // Iterates by index, as filters can be added or removed while delivering. Filters added
+    // meanwhile only get the next event.
+    m_deliveryDepth++;
+    bool accepted = false;
+    const std::size_t count = m_lists[index].size();
+    for (std::size_t i = 0; i < count && !accepted; ++i) {
+        if (EventFilterInterface *filter = m_lists[index][i])
+            accepted = func(filter);
+    }
+    m_deliveryDepth--;
+
+    if (m_deliveryDepth == 0 && m_hasNulls)
+        removeNulls();
+
+    return accepted;
+}
+
+bool EventFilterList::deliverMouseEvent(View *view, MouseEvent *me)
+{
+    return deliver(eventTypeFor(me->type()), [view, me](EventFilterInterface *filter) {
+        if (filter->onMouseEvent(view, me))
+            return true;
+
+        switch (me->type()) {
+        case Event::MouseButtonPress:
+            return filter->onMouseButtonPress(view, me);
+        case Event::MouseButtonRelease:
+            return filter->onMouseButtonRelease(view, me);
+        case Event::MouseMove:
+            return filter->onMouseButtonMove(view, me);
+        case Event::MouseButtonDblClick:
+            return filter->onMouseDoubleClick(view, me);
+        default:
+            break;
+        }
+
+        return false;
+    });
+}
+
+bool EventFilterList::deliverDnDEvent(View *view, Event *ev)
+{
+    return deliver(EventFilterInterface::EventType_DnD, [view, ev](EventFilterInterface *filter) {
+        return filter->onDnDEvent(view, ev);
+    });
+}
+
+bool EventFilterList::deliverMoveEvent(View *view)
+{
+    return deliver(EventFilterInterface::EventType_Move, [view](EventFilterInterface *filter) {
+        return filter->onMoveEvent(view);
+    });
+}
+
+bool EventFilterList::deliverExposeEvent(const std::shared_ptr<Window> &window)
+{
+    return deliver(EventFilterInterface::EventType_Expose, [&window](EventFilterInterface *filter) {
+        return filter->onExposeEvent(window);
+    });
+}
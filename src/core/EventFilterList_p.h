@@ -0,0 +1,69 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "KDDockWidgets.h"
+#include "EventFilterInterface.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace KDDockWidgets::Core {
+
+class View;
+class Window;
+
+/// Event filters, indexed by the event types they handle. See EventFilterInterface::eventTypes().
+/// Delivering an event only visits the filters that want it.
+/// Used for the global filters in Platform::Private and for each View's filters.
+class DOCKS_EXPORT_FOR_UNIT_TESTS EventFilterList
+{
+public:
+    EventFilterList() = default;
+
+    /// Filters are offered events in the order they were added
+    void add(EventFilterInterface *);
+    void remove(EventFilterInterface *);
+
+    /// Returns whether any filter handles @p type.
+    /// Lets callers skip looking up the view or window of an event nobody wants.
+    bool handles(EventFilterInterface::EventType type) const;
+
+    /// Returns the type of list @p type is delivered to, EventType_None if none
+    static EventFilterInterface::EventType eventTypeFor(Event::Type type);
+
+    /// Each one offers the event to the interested filters, until one of them accepts it.
+    /// Filters may be removed while an event is being delivered.
+    bool deliverMouseEvent(View *, MouseEvent *);
+    bool deliverDnDEvent(View *, Event *);
+    bool deliverMoveEvent(View *);
+    bool deliverExposeEvent(const std::shared_ptr<Window> &);
+
+    KDDW_DELETE_COPY_CTOR(EventFilterList)
+
+private:
+    /// One list per single-bit EventFilterInterface::EventType
+    static constexpr std::size_t s_numLists = 7;
+    static std::size_t listIndex(EventFilterInterface::EventType);
+
+    template<typename Func>
+    bool deliver(EventFilterInterface::EventType, Func &&);
+    void removeNulls();
+
+    std::array<std::vector<EventFilterInterface *>, s_numLists> m_lists;
+    int m_deliveryDepth = 0;
+    bool m_hasNulls = false;
+};
+
+}
@@ -12,6 +12,7 @@
 #include "FloatingWindow.h"
 #include "FloatingWindow_p.h"
 #include "MainWindow.h"
+#include "core/JsonWriter_p.h"
 #include "core/Logging_p.h"
 #include "TitleBar.h"
 #include "Group.h"
@@ -22,6 +23,7 @@
 #include "core/Controller_p.h"
 #include "core/WidgetResizeHandler_p.h"
 #include "DockRegistry.h"
+#include "FloatingWindowPool_p.h"
 #include "Config.h"
 #include "Layout_p.h"
 #include "core/ViewFactory.h"
@@ -201,6 +203,29 @@ FloatingWindow::FloatingWindow(Rect suggestedGeometry, MainWindow *parent,
 FloatingWindow::FloatingWindow(Core::Group *group, Rect suggestedGeometry,
                                MainWindow *parent)
     : FloatingWindow({}, hackFindParentHarder(group, parent), floatingWindowFlagsForGroup(group))
+{
+    adoptGroup(group, suggestedGeometry);
+}
+
+FloatingWindow *FloatingWindow::create(Core::Group *group, Rect suggestedGeometry,
+                                       MainWindow *parent)
+{
+    if (Config::self().floatingWindowPoolSize() <= 0)
+        return new FloatingWindow(group, suggestedGeometry, parent);
+
+    // Same parent and flags as the constructor would use
+    parent = hackFindParentHarder(group, parent);
+    const FloatingWindowFlags flags = floatingWindowFlagsForGroup(group);
+
+    FloatingWindow *fw = DockRegistry::self()->floatingWindowPool()->take(parent, flags);
+    if (!fw)
+        fw = new FloatingWindow({}, parent, flags);
+
+    fw->adoptGroup(group, suggestedGeometry);
+    return fw;
+}
+
+void FloatingWindow::adoptGroup(Core::Group *group, Rect suggestedGeometry)
 {
     ScopedValueRollback guard(m_disableSetVisible, true);
 
@@ -250,7 +275,7 @@ FloatingWindow::FloatingWindow(Core::Group *group, Rect suggestedGeometry,
     } else {
         // Adding a widget will trigger onFrameCountChanged, which triggers a setVisible(true).
         // The problem with setVisible(true) will forget about or requested geometry and place the
-        // window at 0,0 So disable the setVisible(true) call while in the ctor.
+        // window at 0,0 So disable the setVisible(true) call while adopting the group.
         d->m_dropArea->addWidget(group->view(), KDDockWidgets::Location_OnTop, {});
     }
 
@@ -303,11 +328,23 @@ std::unique_ptr<WindowBeingDragged> FloatingWindow::makeWindow()
     return std::make_unique<WindowBeingDragged>(this, this);
 }
 
+/// Returns the group if @p layout has exactly one, without building the list of groups
+static Core::Group *onlyGroup(const Layout *layout)
+{
+    Core::Group *result = nullptr;
+    int numGroups = 0;
+    layout->visitGroups([&result, &numGroups](Core::Group *group) {
+        result = group;
+        return ++numGroups < 2;
+    });
+
+    return numGroups == 1 ? result : nullptr;
+}
+
 Core::DockWidget *FloatingWindow::singleDockWidget() const
 {
-    const Core::Group::List groups = this->groups();
-    if (groups.size() == 1) {
-        Core::Group *group = groups.first();
+    // Called for every mouse move while dragging
+    if (Core::Group *group = onlyGroup(d->m_dropArea)) {
         if (group->hasSingleDockWidget())
             return group->dockWidgetAt(0);
     }
@@ -335,13 +372,11 @@ Size FloatingWindow::maxSizeHint() const
         return result;
     }
 
-    const Core::Group::List groups = this->groups();
-    if (groups.size() == 1) {
+    if (Core::Group *group = onlyGroup(d->m_dropArea)) {
         // Let's honour max-size when we have a single-group.
         // multi-group cases are more complicated and we're not sure if we want the window to
         // bounce around. single-group is the most common case, like floating a dock widget, so
         // let's do that first, it's also easy.
-        Core::Group *group = groups[0];
         if (group->dockWidgetCount() == 1) { // We don't support if there's tabbing
             const Size waste =
                 (view()->minSize() - group->view()->minSize()).expandedTo(Size(0, 0));
@@ -413,22 +448,16 @@ bool FloatingWindow::isInDragArea(Point globalPoint) const
 
 bool FloatingWindow::anyNonClosable() const
 {
-    const auto groups = this->groups();
-    for (Core::Group *group : groups) {
-        if (group->anyNonClosable())
-            return true;
-    }
-    return false;
+    return !d->m_dropArea->visitGroups([](Core::Group *group) {
+        return !group->anyNonClosable();
+    });
 }
 
 bool FloatingWindow::anyNonDockable() const
 {
-    const auto groups = this->groups();
-    for (Core::Group *group : groups) {
-        if (group->anyNonDockable())
-            return true;
-    }
-    return false;
+    return !d->m_dropArea->visitGroups([](Core::Group *group) {
+        return !group->anyNonDockable();
+    });
 }
 
 bool FloatingWindow::hasSingleFrame() const
@@ -438,18 +467,20 @@ bool FloatingWindow::hasSingleFrame() const
 
 bool FloatingWindow::hasSingleDockWidget() const
 {
-    const Core::Group::List groups = this->groups();
-    if (groups.size() != 1)
-        return false;
-
-    Core::Group *group = groups.first();
-    return group->dockWidgetCount() == 1;
+    Core::Group *group = onlyGroup(d->m_dropArea);
+    return group && group->dockWidgetCount() == 1;
 }
 
 Core::Group *FloatingWindow::singleFrame() const
 {
-    const Core::Group::List groups = this->groups();
-    return groups.isEmpty() ? nullptr : groups.first();
+    // The first group, even if there's more
+    Core::Group *result = nullptr;
+    d->m_dropArea->visitGroups([&result](Core::Group *group) {
+        result = group;
+        return false;
+    });
+
+    return result;
 }
 
 bool FloatingWindow::beingDeleted() const
@@ -457,13 +488,9 @@ bool FloatingWindow::beingDeleted() const
     if (m_deleteScheduled || m_inDtor)
         return true;
 
-    const auto groups = this->groups();
-    for (Core::Group *f : groups) {
-        if (f->beingDeletedLater())
-            return true;
-    }
-
-    return false;
+    return !d->m_dropArea->visitGroups([](Core::Group *group) {
+        return !group->beingDeletedLater();
+    });
 }
 
 void FloatingWindow::onFrameCountChanged(int count)
@@ -608,6 +635,43 @@ LayoutSaver::FloatingWindow FloatingWindow::serialize() const
     return fw;
 }
 
+void FloatingWindow::serialize(JsonWriter &writer) const
+{
+    // Same JSON as serialize() + to_json(), keys sorted like nlohmann::json does
+    writer.beginObject();
+
+    const Vector<QString> affinities = this->affinities();
+    if (!affinities.isEmpty()) {
+        writer.key("affinities");
+        writer.value(affinities);
+    }
+
+    writer.key("flags");
+    writer.value(int(d->m_flags));
+    writer.key("geometry");
+    writer.value(geometry());
+    writer.key("isVisible");
+    writer.value(isVisible());
+    writer.key("multiSplitterLayout");
+    dropArea()->serialize(writer);
+    writer.key("normalGeometry");
+    writer.value(view()->normalGeometry());
+
+    Window::Ptr transientParentWindow = view()->d->transientWindow();
+    auto transientMainWindow = DockRegistry::self()->mainWindowForHandle(transientParentWindow);
+    writer.key("parentIndex");
+    writer.value(transientMainWindow ? int(DockRegistry::self()->mainwindows().indexOf(transientMainWindow)) : -1);
+
+    writer.key("screenIndex");
+    writer.value(Platform::instance()->screenNumberFor(view()));
+    writer.key("screenSize");
+    writer.value(Platform::instance()->screenSizeFor(view()));
+    writer.key("windowState");
+    writer.value(int(windowStateOverride()));
+
+    writer.endObject();
+}
+
 Rect FloatingWindow::dragRect() const
 {
     Rect rect;
@@ -625,33 +689,29 @@ Rect FloatingWindow::dragRect() const
 
 bool FloatingWindow::allDockWidgetsHave(DockWidgetOption option) const
 {
-    const Core::Group::List groups = this->groups();
-    return std::all_of(groups.begin(), groups.end(), [option](Core::Group *group) {
+    return d->m_dropArea->visitGroups([option](Core::Group *group) {
         return group->allDockWidgetsHave(option);
     });
 }
 
 bool FloatingWindow::anyDockWidgetsHas(DockWidgetOption option) const
 {
-    const Core::Group::List groups = this->groups();
-    return std::any_of(groups.begin(), groups.end(), [option](Core::Group *group) {
-        return group->anyDockWidgetsHas(option);
+    return !d->m_dropArea->visitGroups([option](Core::Group *group) {
+        return !group->anyDockWidgetsHas(option);
     });
 }
 
 bool FloatingWindow::allDockWidgetsHave(LayoutSaverOption option) const
 {
-    const Core::Group::List groups = this->groups();
-    return std::all_of(groups.begin(), groups.end(), [option](Core::Group *group) {
+    return d->m_dropArea->visitGroups([option](Core::Group *group) {
         return group->allDockWidgetsHave(option);
     });
 }
 
 bool FloatingWindow::anyDockWidgetsHas(LayoutSaverOption option) const
 {
-    const Core::Group::List groups = this->groups();
-    return std::any_of(groups.begin(), groups.end(), [option](Core::Group *group) {
-        return group->anyDockWidgetsHas(option);
+    return !d->m_dropArea->visitGroups([option](Core::Group *group) {
+        return !group->anyDockWidgetsHas(option);
     });
 }
 
@@ -28,6 +28,7 @@ namespace KDDockWidgets::Core {
 
 class DropArea;
 class Group;
+class JsonWriter;
 class Layout;
 class MainWindow;
 class TitleBar;
@@ -43,8 +44,14 @@ public:
                             MainWindow *parent = nullptr);
     virtual ~FloatingWindow() override;
 
+    /// Returns a floating window containing @p group. Equivalent to the constructor, but uses a
+    /// pre-created window when Config::setFloatingWindowPoolSize() is set.
+    static FloatingWindow *create(Core::Group *group, Rect suggestedGeometry,
+                                  MainWindow *parent = nullptr);
+
     bool deserialize(const LayoutSaver::FloatingWindow &);
     LayoutSaver::FloatingWindow serialize() const;
+    void serialize(JsonWriter &) const;
 
     // Draggable:
     std::unique_ptr<WindowBeingDragged> makeWindow() override;
@@ -218,6 +225,7 @@ private:
     void onFrameCountChanged(int count);
     void onVisibleFrameCountChanged(int count);
     void onCloseEvent(CloseEvent *);
+    void adoptGroup(Core::Group *group, Rect suggestedGeometry);
     void updateSizeConstraints();
 
     bool m_disableSetVisible = false;
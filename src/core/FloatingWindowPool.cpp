@@ -0,0 +1,169 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "FloatingWindowPool_p.h"
+#include "FloatingWindow.h"
+#include "DelayedCall_p.h"
+#include "DockRegistry.h"
+#include "Platform.h"
+#include "View.h"
+#include "Config.h"
+#include "core/Logging_p.h"
+
+#include <algorithm>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+FloatingWindowPool::~FloatingWindowPool()
+{
+    clear();
+}
+
+FloatingWindow *FloatingWindowPool::take(MainWindow *parent, FloatingWindowFlags flags)
+{
+    auto it = std::find_if(m_windows.begin(), m_windows.end(), [parent, flags](const Entry &entry) {
+        return entry.parent == parent && entry.flags == flags;
+    });
+
+    if (it == m_windows.end()) {
+        m_stats.missed++;
+        scheduleFill(parent, flags);
+        return nullptr;
+    }
+
+    FloatingWindow *fw = it->window;
+    m_windows.erase(it);
+    m_stats.available--;
+    m_stats.taken++;
+
+    // Only now there's room for a replacement
+    scheduleFill(parent, flags);
+
+    KDDW_TRACE("FloatingWindowPool::take: {}", ( void * )fw);
+    DockRegistry::self()->registerFloatingWindow(fw);
+    return fw;
+}
+
+void FloatingWindowPool::scheduleFill(MainWindow *parent, FloatingWindowFlags flags)
+{
+    const int size = Config::self().floatingWindowPoolSize();
+    if (size <= 0)
+        return;
+
+    const Key key = { parent, flags };
+    const bool known = std::any_of(m_keys.cbegin(), m_keys.cend(), [&key](const Key &k) {
+        return k.parent == key.parent && k.flags == key.flags;
+    });
+    if (!known)
+        m_keys.push_back(key);
+
+    if (count(key) < size)
+        scheduleFillOne();
+}
+
+void FloatingWindowPool::scheduleFillOne()
+{
+    if (m_fillScheduled)
+        return;
+
+    m_fillScheduled = true;
+    Platform::instance()->runDelayed(0, new DelayedFillFloatingWindowPool(DockRegistry::self()));
+}
+
+bool FloatingWindowPool::needsFill() const
+{
+    const int size = Config::self().floatingWindowPoolSize();
+    return std::any_of(m_keys.cbegin(), m_keys.cend(), [this, size](const Key &key) {
+        return count(key) < size;
+    });
+}
+
+void FloatingWindowPool::fillOne()
+{
+    m_fillScheduled = false;
+
+    // Nothing can be torn off anymore, don't create windows nobody will use
+    if (DockRegistry::self()->isEmpty())
+        return;
+
+    const int size = Config::self().floatingWindowPoolSize();
+    for (const Key &key : m_keys) {
+        if (count(key) >= size)
+            continue;
+
+        auto fw = new FloatingWindow(Rect(), key.parent, key.flags);
+
+        // Not a top-level for anyone until it's handed out
+        DockRegistry::self()->unregisterFloatingWindow(fw);
+
+        // The expensive part, done now so tearing off doesn't wait for it
+        if (Platform::instance()->isQtWidgets())
+            fw->view()->createPlatformWindow();
+
+        m_windows.push_back({ fw, key.parent, key.flags });
+        m_stats.available++;
+        m_stats.created++;
+        KDDW_TRACE("FloatingWindowPool::fillOne: {}", ( void * )fw);
+
+        break;
+    }
+
+    // One per event loop iteration, so we don't block the UI for long
+    if (needsFill())
+        scheduleFillOne();
+}
+
+void FloatingWindowPool::removeWindowsFor(MainWindow *parent)
+{
+    m_keys.erase(std::remove_if(m_keys.begin(), m_keys.end(), [parent](const Key &key) {
+                     return key.parent == parent;
+                 }),
+                 m_keys.end());
+
+    std::vector<FloatingWindow *> windows;
+    for (auto it = m_windows.begin(); it != m_windows.end();) {
+        if (it->parent == parent) {
+            windows.push_back(it->window);
+            it = m_windows.erase(it);
+            m_stats.available--;
+        } else {
+            ++it;
+        }
+    }
+
+    for (FloatingWindow *fw : windows)
+        delete fw;
+}
+
+void FloatingWindowPool::clear()
+{
+    // Swapped out first, as deleting a window might reenter
+    const std::vector<Entry> windows = std::move(m_windows);
+    m_windows.clear();
+    m_keys.clear();
+    m_stats.available = 0;
+
+    for (const Entry &entry : windows)
+        delete entry.window;
+}
+
+FloatingWindowPool::Stats FloatingWindowPool::stats() const
+{
+    return m_stats;
+}
+
+int FloatingWindowPool::count(const Key &key) const
+{
+    return int(std::count_if(m_windows.cbegin(), m_windows.cend(), [&key](const Entry &entry) {
+        return entry.parent == key.parent && entry.flags == key.flags;
+    }));
+}
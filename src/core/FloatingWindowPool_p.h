@@ -0,0 +1,94 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "kddockwidgets/docks_export.h"
+#include "kddockwidgets/KDDockWidgets.h"
+#include "kddockwidgets/QtCompat_p.h"
+
+#include <vector>
+
+namespace KDDockWidgets::Core {
+
+class FloatingWindow;
+class MainWindow;
+
+/// Keeps hidden, empty floating windows ready, so tearing off a dock widget doesn't wait for a
+/// native window to be created.
+/// Windows are created while the event loop is idle, one per event loop iteration.
+/// Opt-in, see Config::setFloatingWindowPoolSize(). Owned by DockRegistry.
+class DOCKS_EXPORT_FOR_UNIT_TESTS FloatingWindowPool
+{
+public:
+    FloatingWindowPool() = default;
+    ~FloatingWindowPool();
+
+    /// Returns a pre-created window for @p parent and @p flags, registered with DockRegistry.
+    /// Returns nullptr if there's none.
+    /// Either way, schedules creating windows for the same parent and flags, so there's one next time.
+    FloatingWindow *take(MainWindow *parent, FloatingWindowFlags flags);
+
+    /// Schedules creating windows for @p parent and @p flags, if there's less than
+    /// Config::floatingWindowPoolSize()
+    void scheduleFill(MainWindow *parent, FloatingWindowFlags flags);
+
+    /// Creates one missing window. Called by the event loop after scheduleFill().
+    void fillOne();
+
+    /// Deletes the pooled windows which have @p parent as parent.
+    /// Called when a main window is destroyed.
+    void removeWindowsFor(MainWindow *parent);
+
+    /// Deletes the pooled windows
+    void clear();
+
+    struct Stats
+    {
+        int available = 0; ///< pooled right now
+        int created = 0; ///< windows created ahead of time
+        int taken = 0; ///< windows handed out by take()
+        int missed = 0; ///< calls to take() which had to return nullptr
+    };
+    Stats stats() const;
+
+    KDDW_DELETE_COPY_CTOR(FloatingWindowPool)
+
+private:
+    struct Entry
+    {
+        FloatingWindow *window = nullptr;
+        MainWindow *parent = nullptr;
+        FloatingWindowFlags flags;
+    };
+
+    /// A parent and flags combination that windows are kept for
+    struct Key
+    {
+        MainWindow *parent = nullptr;
+        FloatingWindowFlags flags;
+    };
+
+    int count(const Key &) const;
+
+    /// Returns whether any parent and flags combination has less windows than the pool size
+    bool needsFill() const;
+
+    /// Schedules fillOne() for the next event loop iteration, unless it's already scheduled
+    void scheduleFillOne();
+
+    std::vector<Entry> m_windows;
+    std::vector<Key> m_keys;
+    bool m_fillScheduled = false;
+    Stats m_stats;
+};
+
+}
@@ -36,6 +36,7 @@
 #include "DockWidget_p.h"
 #include "ObjectGuard_p.h"
 
+#include "core/JsonWriter_p.h"
 #include "core/Logging_p.h"
 #include "core/Utils_p.h"
 #include "core/View_p.h"
@@ -43,6 +44,7 @@
 #include "core/Position_p.h"
 #include "core/WidgetResizeHandler_p.h"
 #include "core/DelayedCall_p.h"
+#include "core/GroupPool_p.h"
 #include "core/layouting/Item_p.h"
 
 #include "kdbindings/signal.h"
@@ -106,7 +108,8 @@ Group::Group(View *parent, FrameOptions options, int userType)
 Group::~Group()
 {
     m_inDtor = true;
-    s_dbg_numFrames--;
+    if (!d->m_isPooled)
+        s_dbg_numFrames--;
     if (d->m_layoutItem)
         d->m_layoutItem->unref();
 
@@ -122,6 +125,16 @@ Group::~Group()
     delete d;
 }
 
+Group *Group::create(View *parent, FrameOptions options, int userType)
+{
+    if (Config::self().groupPoolSize() > 0) {
+        if (Group *group = DockRegistry::self()->groupPool()->take(parent, options, userType))
+            return group;
+    }
+
+    return new Group(parent, options, userType);
+}
+
 void Group::onCloseEvent(CloseEvent *e)
 {
     e->accept(); // Accepted by default (will close unless ignored)
@@ -307,14 +320,14 @@ FloatingWindow *Group::detachTab(DockWidget *dockWidget)
     Rect r = dockWidget->geometry();
     removeWidget(dockWidget);
 
-    auto newGroup = new Group();
+    auto newGroup = Group::create();
     const Point globalPoint = mapToGlobal(Point(0, 0));
     newGroup->addTab(dockWidget);
 
     // We're potentially already dead at this point, as groups with 0 tabs auto-destruct. Don't
     // access members from this point.
 
-    auto floatingWindow = new FloatingWindow(newGroup, {});
+    auto floatingWindow = FloatingWindow::create(newGroup, {});
     r.moveTopLeft(globalPoint);
     floatingWindow->setSuggestedGeometry(r, SuggestedGeometryHint_GeometryIsFromDocked);
     floatingWindow->view()->show();
@@ -628,6 +641,11 @@ LayoutingHost *Group::Private::host() const
 
 void Group::Private::setHost(LayoutingHost *host)
 {
+    if (host && host == this->host()) {
+        // Already there. Avoids needlessly reparenting when a restore reuses this group.
+        return;
+    }
+
     Core::View *parent = nullptr;
     if (auto layout = Layout::fromLayoutingHost(host)) {
         parent = layout->view();
@@ -717,7 +735,10 @@ Group *Group::deserialize(const LayoutSaver::Group &f)
     Group *group = nullptr;
     const bool isPersistentCentralFrame = options & FrameOption::FrameOption_IsCentralFrame;
 
-    if (isPersistentCentralFrame) {
+    if (f.reusedGroup) {
+        // Kept from the previous layout, it already has the right tabs. See RestoreOption_ReuseGroups.
+        group = f.reusedGroup;
+    } else if (isPersistentCentralFrame) {
         // Don't create a new Group if we're restoring the Persistent Central group (the one created
         // by MainWindowOption_HasCentralFrame). It already exists.
 
@@ -740,13 +761,14 @@ Group *Group::deserialize(const LayoutSaver::Group &f)
     }
 
     if (!group)
-        group = new Group(nullptr, options);
+        group = Group::create(nullptr, options);
 
     group->setObjectName(f.objectName);
 
     for (const auto &savedDock : std::as_const(f.dockWidgets)) {
         if (DockWidget *dw = DockWidget::deserialize(savedDock)) {
-            group->addTab(dw);
+            if (!f.reusedGroup)
+                group->addTab(dw);
         }
     }
 
@@ -784,11 +806,60 @@ LayoutSaver::Group Group::serialize() const
     return group;
 }
 
+void Group::serialize(JsonWriter &writer) const
+{
+    // Same JSON as serialize() + to_json(), keys sorted like nlohmann::json does
+    const DockWidget::List docks = dockWidgets();
+
+    int tabIndex = currentTabIndex();
+    if (tabIndex == -1 && !docks.isEmpty()) {
+        KDDW_ERROR("Group::serialize: Current index shouldn't be -1. Setting to 0 instead.");
+        tabIndex = 0;
+    }
+
+    writer.beginObject();
+    writer.key("currentTabIndex");
+    writer.value(tabIndex);
+
+    writer.key("dockWidgets");
+    if (docks.isEmpty()) {
+        writer.nullValue();
+    } else {
+        writer.beginArray();
+        for (DockWidget *dock : docks)
+            writer.value(dock->uniqueName());
+        writer.endArray();
+    }
+
+    writer.key("geometry");
+    writer.value(geometry());
+    writer.key("id");
+    writer.value(view()->d->id());
+    writer.key("isNull");
+    writer.value(false);
+    writer.key("mainWindowUniqueName");
+    if (MainWindow *mw = mainWindow())
+        writer.value(mw->uniqueName());
+    else
+        writer.value(QString());
+    writer.key("objectName");
+    writer.value(objectName());
+    writer.key("options");
+    writer.value(int(options()));
+    writer.endObject();
+}
+
 void Group::scheduleDeleteLater()
 {
     KDDW_TRACE("Group::scheduleDeleteLater: {}", ( void * )this);
     m_beingDeleted = true;
 
+    if (Config::self().groupPoolSize() > 0) {
+        // Deleted, or recycled if the pool has room
+        Platform::instance()->runDelayed(0, new DelayedRecycleGroup(this));
+        return;
+    }
+
     // Can't use deleteLater() here due to QTBUG-83030 (deleteLater() never delivered if
     // triggered by a sendEvent() before event loop starts)
     destroyLater();
@@ -1017,6 +1088,42 @@ Group::Private::Private(Group *qq, int userType, FrameOptions options)
     q->view()->d->layoutInvalidated.connect([this] { layoutInvalidated.emit(); });
 }
 
+bool Group::Private::canBeReusedAs(FrameOptions options, int userType) const
+{
+    // The Stack's options and the views created by the ViewFactory depend on these
+    return m_options == actualOptions(options) && m_userType == userType;
+}
+
+void Group::Private::prepareForPool()
+{
+    // Same as ~Group() does, without destroying anything.
+    // Layout items that still reference us turn into placeholders or are removed.
+    setLayoutItem(nullptr);
+    q->setLayout(nullptr);
+    beingDestroyed.emit();
+
+    q->setParentView(nullptr);
+    q->view()->setVisible(false);
+    q->setObjectName({});
+    q->m_titleBar->setTitle({});
+    q->m_titleBar->setIcon({});
+
+    DockRegistry::self()->unregisterGroup(q);
+    s_dbg_numFrames--;
+    m_isPooled = true;
+}
+
+void Group::Private::reuse(View *parent)
+{
+    m_isPooled = false;
+    s_dbg_numFrames++;
+    DockRegistry::self()->registerGroup(q);
+
+    q->m_beingDeleted = false;
+    q->setParentView(parent);
+    q->setLayout(parent ? parent->asLayout() : nullptr);
+}
+
 Group::Private::~Private()
 {
     m_visibleWidgetCountChangedConnection->disconnect();
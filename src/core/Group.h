@@ -28,6 +28,7 @@ class WidgetResizeHandler;
 namespace KDDockWidgets::Core {
 
 class LayoutingGuest;
+class JsonWriter;
 class DropArea;
 class MDILayout;
 class DockWidget;
@@ -36,6 +37,7 @@ class MainWindow;
 class Stack;
 class TabBar;
 class TitleBar;
+class GroupPool;
 
 class DOCKS_EXPORT Group : public Controller, public FocusScope
 {
@@ -47,8 +49,14 @@ public:
                    int userType = 0);
     virtual ~Group() override;
 
+    /// Returns a recycled group if Config::setGroupPoolSize() enabled recycling and there's a
+    /// suitable one, otherwise a new group
+    static Group *create(View *parent = nullptr, FrameOptions = FrameOption_None,
+                         int userType = 0);
+
     static Group *deserialize(const LayoutSaver::Group &);
     LayoutSaver::Group serialize() const;
+    void serialize(JsonWriter &) const;
 
     ///@brief Adds a widget into the Group's Stack
     void addTab(DockWidget *, InitialOption = {});
@@ -339,6 +347,7 @@ private:
     KDDW_DELETE_COPY_CTOR(Group)
     friend class ::TestDocks;
     friend class KDDockWidgets::Core::Stack;
+    friend class KDDockWidgets::Core::GroupPool;
 
     void scheduleDeleteLater();
     void onCloseEvent(CloseEvent *);
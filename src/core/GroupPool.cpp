@@ -0,0 +1,81 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "GroupPool_p.h"
+#include "Group.h"
+#include "Group_p.h"
+#include "Config.h"
+#include "core/Logging_p.h"
+
+#include <algorithm>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+GroupPool::~GroupPool()
+{
+    clear();
+}
+
+Group *GroupPool::take(View *parent, FrameOptions options, int userType)
+{
+    for (int i = int(m_groups.size()) - 1; i >= 0; --i) {
+        Group *group = m_groups.at(i);
+        if (!group->d->canBeReusedAs(options, userType))
+            continue;
+
+        m_groups.removeAt(i);
+        m_stats.available--;
+        m_stats.reused++;
+
+        group->d->reuse(parent);
+        KDDW_TRACE("GroupPool::take: {}", ( void * )group);
+        return group;
+    }
+
+    return nullptr;
+}
+
+bool GroupPool::release(Group *group)
+{
+    if (!group->isEmpty() || group->isCentralFrame() || group->inDtor())
+        return false;
+
+    if (int(m_groups.size()) >= Config::self().groupPoolSize()) {
+        m_stats.discarded++;
+        return false;
+    }
+
+    KDDW_TRACE("GroupPool::release: {}", ( void * )group);
+    group->d->prepareForPool();
+    m_groups.push_back(group);
+
+    m_stats.available++;
+    m_stats.peak = std::max(m_stats.peak, m_stats.available);
+
+    return true;
+}
+
+void GroupPool::clear()
+{
+    // Swapped out first, as deleting a group might reenter
+    const Vector<Group *> groups = std::move(m_groups);
+    m_groups.clear();
+    m_stats.available = 0;
+
+    for (Group *group : groups)
+        delete group;
+}
+
+GroupPool::Stats GroupPool::stats() const
+{
+    return m_stats;
+}
@@ -0,0 +1,59 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "kddockwidgets/docks_export.h"
+#include "kddockwidgets/KDDockWidgets.h"
+#include "kddockwidgets/QtCompat_p.h"
+
+namespace KDDockWidgets::Core {
+
+class Group;
+class View;
+
+/// Keeps emptied groups, so the next docking operation reuses them, together with their
+/// Stack, TabBar and TitleBar, instead of creating new ones.
+/// Opt-in, see Config::setGroupPoolSize(). Owned by DockRegistry.
+class DOCKS_EXPORT_FOR_UNIT_TESTS GroupPool
+{
+public:
+    GroupPool() = default;
+    ~GroupPool();
+
+    /// Returns a pooled group with the same options and user type, now parented to @p parent.
+    /// Returns nullptr if there's none.
+    Group *take(View *parent, FrameOptions options, int userType);
+
+    /// Resets the emptied @p group and keeps it.
+    /// Returns false if the pool is full or the group can't be recycled, the caller deletes it then.
+    bool release(Group *group);
+
+    /// Deletes the pooled groups
+    void clear();
+
+    struct Stats
+    {
+        int available = 0; ///< pooled right now
+        int peak = 0; ///< the most there were pooled at once
+        int reused = 0; ///< groups taken from the pool instead of created
+        int discarded = 0; ///< emptied groups deleted because the pool was full
+    };
+    Stats stats() const;
+
+    KDDW_DELETE_COPY_CTOR(GroupPool)
+
+private:
+    Vector<Group *> m_groups;
+    Stats m_stats;
+};
+
+}
@@ -98,9 +98,15 @@ public:
         return q->view()->d->freed();
     }
 
+    /// Recycling, see GroupPool
+    bool canBeReusedAs(FrameOptions options, int userType) const;
+    void prepareForPool();
+    void reuse(View *parent);
+
     Group *const q;
     int m_userType = 0;
     FrameOptions m_options = FrameOption_None;
+    bool m_isPooled = false;
 };
 
 }
@@ -0,0 +1,374 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "JsonWriter_p.h"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+namespace {
+/// Same indentation as nlohmann::json::dump(4)
+constexpr int s_indentStep = 4;
+
+/// Output is handed to the sink in chunks of about this size
+constexpr std::size_t s_chunkSize = 16 * 1024;
+}
+
+JsonWriter::JsonWriter(Sink sink, Encoding encoding)
+    : m_sink(std::move(sink))
+    , m_encoding(encoding)
+{
+    m_buffer.reserve(s_chunkSize + 1024);
+}
+
+JsonWriter::~JsonWriter()
+{
+    flush();
+}
+
+void JsonWriter::flush()
+{
+    if (!m_buffer.empty()) {
+        m_sink(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+}
+
+void JsonWriter::write(const char *data, std::size_t size)
+{
+    m_buffer.append(data, size);
+    if (m_buffer.size() >= s_chunkSize)
+        flush();
+}
+
+void JsonWriter::write(char c)
+{
+    m_buffer.push_back(c);
+    if (m_buffer.size() >= s_chunkSize)
+        flush();
+}
+
+void JsonWriter::writeCborHead(uint8_t majorType, uint64_t argument)
+{
+    const auto type = uint8_t(majorType << 5);
+    if (argument < 24) {
+        write(char(type | argument));
+        return;
+    }
+
+    // The argument follows the initial byte, in 1, 2, 4 or 8 bytes, big-endian
+    int numBytes = 8;
+    uint8_t additionalInfo = 27;
+    if (argument <= 0xFF) {
+        numBytes = 1;
+        additionalInfo = 24;
+    } else if (argument <= 0xFFFF) {
+        numBytes = 2;
+        additionalInfo = 25;
+    } else if (argument <= 0xFFFFFFFF) {
+        numBytes = 4;
+        additionalInfo = 26;
+    }
+
+    write(char(type | additionalInfo));
+    for (int i = numBytes - 1; i >= 0; --i)
+        write(char((argument >> (i * 8)) & 0xFF));
+}
+
+void JsonWriter::writeIndent()
+{
+    m_buffer.append(m_levels.size() * s_indentStep, ' ');
+}
+
+void JsonWriter::beginValue()
+{
+    if (m_encoding == Encoding::Cbor) {
+        // No separators nor indentation in CBOR
+        return;
+    }
+
+    if (m_afterKey) {
+        // Object members already got their separator and indentation in key()
+        m_afterKey = false;
+        return;
+    }
+
+    if (m_levels.empty())
+        return;
+
+    // An array element
+    Level &level = m_levels.back();
+    write(level.hasChildren ? ",\n" : "\n", level.hasChildren ? 2 : 1);
+    level.hasChildren = true;
+    writeIndent();
+}
+
+void JsonWriter::beginContainer(char c)
+{
+    beginValue();
+    if (m_encoding == Encoding::Cbor) {
+        // Indefinite-length map (major type 5) or array (major type 4)
+        write(char(c == '{' ? 0xBF : 0x9F));
+    } else {
+        write(c);
+    }
+    m_levels.push_back({});
+}
+
+void JsonWriter::endContainer(char c)
+{
+    assert(!m_levels.empty());
+    const bool hasChildren = m_levels.back().hasChildren;
+    m_levels.pop_back();
+
+    if (m_encoding == Encoding::Cbor) {
+        // The "break" stop code ends indefinite-length items
+        write(char(0xFF));
+        return;
+    }
+
+    if (hasChildren) {
+        write('\n');
+        writeIndent();
+    }
+
+    write(c);
+}
+
+void JsonWriter::beginObject()
+{
+    beginContainer('{');
+}
+
+void JsonWriter::endObject()
+{
+    endContainer('}');
+}
+
+void JsonWriter::beginArray()
+{
+    beginContainer('[');
+}
+
+void JsonWriter::endArray()
+{
+    endContainer(']');
+}
+
+void JsonWriter::key(const char *name)
+{
+    writeKey(name, std::strlen(name));
+}
+
+void JsonWriter::key(const QString &name)
+{
+#ifdef KDDW_FRONTEND_QT
+    const QByteArray utf8 = name.toUtf8();
+    writeKey(utf8.constData(), std::size_t(utf8.size()));
+#else
+    writeKey(name.data(), name.size());
+#endif
+}
+
+void JsonWriter::writeKey(const char *data, std::size_t size)
+{
+    assert(!m_levels.empty());
+    assert(!m_afterKey);
+
+    if (m_encoding == Encoding::Cbor) {
+        writeString(data, size);
+        return;
+    }
+
+    Level &level = m_levels.back();
+    write(level.hasChildren ? ",\n" : "\n", level.hasChildren ? 2 : 1);
+    level.hasChildren = true;
+    writeIndent();
+
+    writeString(data, size);
+    write(": ", 2);
+    m_afterKey = true;
+}
+
+void JsonWriter::nullValue()
+{
+    beginValue();
+    if (m_encoding == Encoding::Cbor)
+        write(char(0xF6));
+    else
+        write("null", 4);
+}
+
+void JsonWriter::value(bool b)
+{
+    beginValue();
+    if (m_encoding == Encoding::Cbor)
+        write(char(b ? 0xF5 : 0xF4));
+    else if (b)
+        write("true", 4);
+    else
+        write("false", 5);
+}
+
+void JsonWriter::value(int i)
+{
+    beginValue();
+    if (m_encoding == Encoding::Cbor) {
+        // Major type 0 for unsigned integers, 1 for negative ones, encoded as -1 - n
+        if (i >= 0)
+            writeCborHead(0, uint64_t(i));
+        else
+            writeCborHead(1, uint64_t(-1 - int64_t(i)));
+        return;
+    }
+
+    std::array<char, 16> buffer;
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), i);
+    write(buffer.data(), std::size_t(result.ptr - buffer.data()));
+}
+
+void JsonWriter::value(double d)
+{
+    if (!std::isfinite(d)) {
+        // Like dump() does
+        nullValue();
+        return;
+    }
+
+    beginValue();
+    if (m_encoding == Encoding::Cbor) {
+        // Double-precision float, big-endian
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        write(char(0xFB));
+        for (int i = 7; i >= 0; --i)
+            write(char((bits >> (i * 8)) & 0xFF));
+        return;
+    }
+
+    // Use nlohmann's own Grisu2 implementation, so the digits match dump()
+    std::array<char, 64> buffer;
+    const char *end = nlohmann::detail::to_chars(buffer.data(), buffer.data() + buffer.size(), d);
+    write(buffer.data(), std::size_t(end - buffer.data()));
+}
+
+void JsonWriter::value(const QString &str)
+{
+    beginValue();
+#ifdef KDDW_FRONTEND_QT
+    const QByteArray utf8 = str.toUtf8();
+    writeString(utf8.constData(), std::size_t(utf8.size()));
+#else
+    writeString(str.data(), str.size());
+#endif
+}
+
+void JsonWriter::value(Rect rect)
+{
+    beginObject();
+    key("height");
+    value(rect.height());
+    key("width");
+    value(rect.width());
+    key("x");
+    value(rect.x());
+    key("y");
+    value(rect.y());
+    endObject();
+}
+
+void JsonWriter::value(Size size)
+{
+    beginObject();
+    key("height");
+    value(size.height());
+    key("width");
+    value(size.width());
+    endObject();
+}
+
+void JsonWriter::value(const Vector<QString> &strings)
+{
+    if (strings.isEmpty()) {
+        nullValue();
+        return;
+    }
+
+    beginArray();
+    for (const QString &str : strings)
+        value(str);
+    endArray();
+}
+
+void JsonWriter::writeString(const char *data, std::size_t size)
+{
+    if (m_encoding == Encoding::Cbor) {
+        // Text string, major type 3. UTF-8 is written as is.
+        writeCborHead(3, size);
+        write(data, size);
+        return;
+    }
+
+    // Escapes like nlohmann::json::dump() with ensure_ascii=false does. Multi-byte UTF-8
+    // sequences are copied verbatim.
+    write('"');
+
+    std::size_t unescapedStart = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto c = static_cast<unsigned char>(data[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        write(data + unescapedStart, i - unescapedStart);
+        unescapedStart = i + 1;
+
+        switch (c) {
+        case '\b':
+            write("\\b", 2);
+            break;
+        case '\t':
+            write("\\t", 2);
+            break;
+        case '\n':
+            write("\\n", 2);
+            break;
+        case '\f':
+            write("\\f", 2);
+            break;
+        case '\r':
+            write("\\r", 2);
+            break;
+        case '"':
+            write("\\\"", 2);
+            break;
+        case '\\':
+            write("\\\\", 2);
+            break;
+        default: {
+            static const char hexDigits[] = "0123456789abcdef";
+            const char escaped[] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF] };
+            write(escaped, sizeof(escaped));
+            break;
+        }
+        }
+    }
+
+    write(data + unescapedStart, size - unescapedStart);
+    write('"');
+}
@@ -0,0 +1,96 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "KDDockWidgets.h"
+#include "QtCompat_p.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace KDDockWidgets::Core {
+
+/// Writes JSON directly to a sink, without building a nlohmann::json DOM first.
+///
+/// The output is byte-identical to nlohmann::json::dump(4), as long as the caller writes
+/// object keys in alphabetical order, which is how nlohmann::json stores them.
+/// Used by LayoutSaver to serialize layouts straight from the live objects.
+///
+/// With Encoding::Cbor the same document is written as CBOR (RFC 8949) instead, which
+/// nlohmann::json::from_cbor() reads back into the same DOM as parse() does for the text.
+class DOCKS_EXPORT_FOR_UNIT_TESTS JsonWriter
+{
+public:
+    /// Receives chunks of output
+    using Sink = std::function<void(const char *data, std::size_t size)>;
+
+    enum class Encoding {
+        Text, ///< Indented JSON, like nlohmann::json::dump(4)
+        Cbor ///< Binary. Objects and arrays are written with indefinite length.
+    };
+
+    explicit JsonWriter(Sink, Encoding = Encoding::Text);
+
+    /// Flushes any pending output
+    ~JsonWriter();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /// Writes the key of the next value. Keys of the same object must be written sorted.
+    void key(const char *);
+    void key(const QString &);
+
+    void nullValue();
+    void value(bool);
+    void value(int);
+    void value(double);
+    void value(const QString &);
+    void value(Rect);
+    void value(Size);
+
+    /// Writes an empty list as null, like the nlohmann::json to_json() for Vector<QString> does
+    void value(const Vector<QString> &);
+
+    /// Hands all buffered output to the sink
+    void flush();
+
+    KDDW_DELETE_COPY_CTOR(JsonWriter)
+
+private:
+    void beginValue();
+    void beginContainer(char c);
+    void endContainer(char c);
+    void writeIndent();
+    void writeKey(const char *data, std::size_t size);
+    void writeString(const char *data, std::size_t size);
+    void write(const char *data, std::size_t size);
+    void write(char c);
+    void writeCborHead(uint8_t majorType, uint64_t argument);
+
+    struct Level
+    {
+        bool hasChildren = false;
+    };
+
+    const Sink m_sink;
+    const Encoding m_encoding;
+    std::string m_buffer;
+    std::vector<Level> m_levels;
+    bool m_afterKey = false;
+};
+
+}
@@ -18,6 +18,7 @@
 #include "ViewFactory.h"
 #include "Utils_p.h"
 #include "View_p.h"
+#include "JsonWriter_p.h"
 #include "Logging_p.h"
 #include "ScopedValueRollback_p.h"
 #include "DropArea.h"
@@ -27,6 +28,7 @@
 #include "MainWindow.h"
 #include "layouting/Item_p.h"
 
+#include <algorithm>
 #include <unordered_map>
 
 using namespace KDDockWidgets;
@@ -61,6 +63,9 @@ void Layout::viewAboutToBeDeleted()
             d->m_rootItem = nullptr;
         }
 
+        // Pooled separators are children of our view
+        d->clearSeparatorPool();
+
         d->m_viewDeleted = true;
     }
 }
@@ -154,7 +159,7 @@ void Layout::dumpLayout() const
 void Layout::restorePlaceholder(Core::DockWidget *dw, Core::Item *item, int tabIndex)
 {
     if (item->isPlaceholder()) {
-        auto newGroup = new Core::Group(view());
+        auto newGroup = Core::Group::create(view());
         item->restore(newGroup->asLayoutingGuest());
     }
 
@@ -235,9 +240,10 @@ Core::Item *Layout::itemForFrame(const Core::Group *group) const
 Core::DockWidget::List Layout::dockWidgets() const
 {
     Core::DockWidget::List dockWidgets;
-    const Core::Group::List groups = this->groups();
-    for (Core::Group *group : groups)
-        dockWidgets.append(group->dockWidgets());
+    visitGroups([&dockWidgets](Core::Group *group) {
+        for (int i = 0, count = group->dockWidgetCount(); i < count; ++i)
+            dockWidgets.push_back(group->dockWidgetAt(i));
+    });
 
     return dockWidgets;
 }
@@ -255,16 +261,10 @@ Core::Group::List Layout::groupsFrom(View *groupOrMultiSplitter) const
 
 Core::Group::List Layout::groups() const
 {
-    const Core::Item::List items = d->m_rootItem->items_recursive();
-
     Core::Group::List result;
-    result.reserve(items.size());
-
-    for (Core::Item *item : items) {
-        if (auto group = Group::fromItem(item)) {
-            result.push_back(group);
-        }
-    }
+    visitGroups([&result](Core::Group *group) {
+        result.push_back(group);
+    });
 
     return result;
 }
@@ -298,12 +298,20 @@ bool Layout::deserialize(const LayoutSaver::MultiSplitter &l)
         groups[group.id] = f->asLayoutingGuest();
     }
 
+    Core::LayoutTransaction transaction(d->m_rootItem);
     d->m_rootItem->fillFromJson(l.layout, groups);
     updateSizeConstraints();
 
     const Size newLayoutSize = view()->size().expandedTo(d->m_rootItem->minSize());
 
     d->m_rootItem->setSize_recursive(newLayoutSize);
+    transaction.commit();
+
+#ifdef DOCKS_DEVELOPER_MODE
+    // fillFromJson()'s own check ran inside the transaction above, which makes it a no-op
+    if (!Core::Item::s_silenceSanityChecks && !checkSanity())
+        KDDW_ERROR("Layout::deserialize: Resulting layout is invalid");
+#endif
 
     return true;
 }
@@ -324,17 +332,40 @@ LayoutSaver::MultiSplitter Layout::serialize() const
 {
     LayoutSaver::MultiSplitter l;
     d->m_rootItem->to_json(l.layout);
-    const Core::Item::List items = d->m_rootItem->items_recursive();
-    l.groups.reserve(size_t(items.size()));
-    for (Core::Item *item : items) {
-        if (!item->isContainer()) {
-            if (auto group = Group::fromItem(item)) {
-                l.groups[group->view()->d->id()] = group->serialize();
-            }
+    l.groups.reserve(size_t(count()));
+    visitGroups([&l](Core::Group *group) {
+        l.groups[group->view()->d->id()] = group->serialize();
+    });
+
+    return l;
+}
+
+void Layout::serialize(JsonWriter &writer) const
+{
+    // Same JSON as serialize() + to_json(). nlohmann::json sorts object keys, so groups are
+    // written sorted by id.
+    Vector<Group *> groups = this->groups();
+
+    std::sort(groups.begin(), groups.end(), [](Group *g1, Group *g2) {
+        return g1->view()->d->id() < g2->view()->d->id();
+    });
+
+    writer.beginObject();
+    writer.key("frames");
+    if (groups.isEmpty()) {
+        writer.nullValue();
+    } else {
+        writer.beginObject();
+        for (Group *group : std::as_const(groups)) {
+            writer.key(group->view()->d->id());
+            group->serialize(writer);
         }
+        writer.endObject();
     }
 
-    return l;
+    writer.key("layout");
+    d->m_rootItem->serialize(writer);
+    writer.endObject();
 }
 
 Core::DropArea *Layout::asDropArea() const
@@ -377,6 +408,11 @@ Layout::Private *Layout::d_ptr()
     return d;
 }
 
+int Layout::Private::maxPooledSeparators() const
+{
+    return Config::self().separatorPoolSize();
+}
+
 bool Layout::Private::supportsHonouringLayoutMinSize() const
 {
     if (auto window = q->view()->window()) {
@@ -40,6 +40,7 @@ class DockWidget;
 class MainWindow;
 class Item;
 class ItemContainer;
+class JsonWriter;
 class Separator;
 
 /**
@@ -170,6 +171,13 @@ public:
      */
     Vector<Core::Group *> groups() const;
 
+    /// Calls @p visitor for each group, in layout order, without building a list like groups().
+    /// Groups whose view is already being destroyed are skipped.
+    /// @p visitor takes a Group * and can return false to stop early, then this returns false.
+    /// The layout mustn't change during the visit. Defined in Layout_p.h
+    template<typename Visitor>
+    bool visitGroups(Visitor &&visitor) const;
+
     /// @brief Returns the list of dock widgets contained in this layout
     Vector<Core::DockWidget *> dockWidgets() const;
 
@@ -185,6 +193,7 @@ public:
 
     virtual bool deserialize(const LayoutSaver::MultiSplitter &);
     LayoutSaver::MultiSplitter serialize() const;
+    void serialize(JsonWriter &) const;
 
     Core::DropArea *asDropArea() const;
     Core::MDILayout *asMDILayout() const;
@@ -18,6 +18,7 @@
 #include "core/Window_p.h"
 #include "nlohmann_helpers_p.h"
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <map>
@@ -34,7 +35,10 @@
 namespace KDDockWidgets {
 
 namespace Core {
+class DockWidget;
 class FloatingWindow;
+class Group;
+class JsonWriter;
 class View;
 }
 
@@ -48,7 +52,8 @@ enum class InternalRestoreOption {
     None = 0,
     SkipMainWindowGeometry = 1, ///< Don't reposition the main window's geometry when restoring.
     RelativeFloatingWindowGeometry =
-        2 ///< FloatingWindow's are repositioned relatively to the new MainWindow's size
+        2, ///< FloatingWindow's are repositioned relatively to the new MainWindow's size
+    ReuseGroups = 4 ///< See RestoreOption_ReuseGroups
 };
 Q_DECLARE_FLAGS(InternalRestoreOptions, InternalRestoreOption)
 
@@ -115,19 +120,9 @@ struct DOCKS_EXPORT LayoutSaver::DockWidget
     /// RestoreOption_RelativeToMainWindow.
     void scaleSizes(const ScalingInfo &scalingInfo);
 
-    static Ptr dockWidgetForName(const QString &name)
-    {
-        auto it = s_dockWidgets.find(name);
-        auto dw = it == s_dockWidgets.cend() ? nullptr : it->second;
-        if (dw)
-            return dw;
-
-        dw = Ptr(new LayoutSaver::DockWidget);
-        s_dockWidgets[name] = dw;
-        dw->uniqueName = name;
-
-        return dw;
-    }
+    /// Returns the shared instance for @p name, from s_dockWidgets, creating it if needed.
+    /// GUI thread only.
+    static Ptr dockWidgetForName(const QString &name);
 
     bool skipsRestore() const;
 
@@ -173,6 +168,9 @@ struct LayoutSaver::Group
     QString mainWindowUniqueName;
 
     LayoutSaver::DockWidget::List dockWidgets;
+
+    // The existing group that is kept during a restore, see RestoreOption_ReuseGroups:
+    Core::Group *reusedGroup = nullptr;
 };
 
 struct LayoutSaver::MultiSplitter
@@ -287,6 +285,24 @@ public:
     QByteArray toJson() const;
     bool fromJson(const QByteArray &jsonData);
 
+    /// Same document as toJson(), but as CBOR, preceded by s_binaryHeader
+    QByteArray toBinary() const;
+    bool fromBinary(const QByteArray &data);
+
+    /// Returns whether @p data starts with s_binaryHeader
+    static bool isBinary(const QByteArray &data);
+
+    /// Calls fromBinary() or fromJson(), depending on what @p data contains
+    bool fromData(const QByteArray &data);
+
+    /// Fills this layout from an already parsed document. GUI thread only, as it interns the dock
+    /// widgets in LayoutSaver::DockWidget::s_dockWidgets.
+    bool fromDom(const nlohmann::json &json);
+
+    /// Binary layouts start with these 8 bytes. The last one is the version of the binary
+    /// container, not of the layout, which is in serializationVersion as usual.
+    static constexpr char s_binaryHeader[] = { 'K', 'D', 'D', 'W', 'B', 'I', 'N', 1 };
+
     /// Iterates through the layout and patches all absolute sizes. See
     /// RestoreOption_RelativeToMainWindow.
     void scaleSizes(KDDockWidgets::InternalRestoreOptions);
@@ -325,9 +341,36 @@ public:
     explicit Private(RestoreOptions options);
 
     bool matchesAffinity(const Vector<QString> &affinities) const;
+
+    /// Parses @p data, JSON or binary, into a document. Returns a discarded value if it's invalid.
+    /// Doesn't touch any GUI or global state, so it's safe to call from a worker thread.
+    static nlohmann::json parseLayoutData(const QByteArray &data);
+
+    /// Builds a LayoutSaver::Layout from @p dom, validates it and applies it. GUI thread only.
+    bool restoreParsedLayout(const nlohmann::json &dom);
+
+    /// Scales @p layout and applies it to the live windows and dock widgets. GUI thread only.
+    bool applyLayout(LayoutSaver::Layout &layout);
+
+#ifdef DOCKS_TESTING_METHODS
+    /// Serializes the way serializeLayout() did before streaming: copies everything into a
+    /// LayoutSaver::Layout and dumps its to_json(). Lets tests check that both paths agree.
+    QByteArray serializeThroughLayout() const;
+#endif
+
+    /// Writes the whole layout to @p sink, straight from the live windows and dock widgets.
+    /// Uses the format set by LayoutSaver::setFormat(). Produces the same output as
+    /// LayoutSaver::Layout::toJson() or toBinary().
+    bool serializeLayout(const std::function<void(const char *, std::size_t)> &sink) const;
+    void writeLayout(Core::JsonWriter &) const;
     void floatWidgetsWhichSkipRestore(const Vector<QString> &mainWindowNames);
     void floatUnknownWidgets(const LayoutSaver::Layout &layout);
 
+    /// Finds the main window groups which already have the same tabs as the saved ones and marks
+    /// them for reuse. Their dock widgets are removed from @p dockWidgetsToClose.
+    void reuseUnchangedGroups(LayoutSaver::Layout &layout,
+                              Vector<Core::DockWidget *> &dockWidgetsToClose);
+
     template<typename T>
     void deserializeWindowGeometry(const T &saved, Core::Window::Ptr);
     void deleteEmptyGroups() const;
@@ -336,6 +379,7 @@ public:
     DockRegistry *const m_dockRegistry;
     InternalRestoreOptions m_restoreOptions = {};
     Vector<QString> m_affinityNames;
+    LayoutSaverFormat m_format = LayoutSaverFormat::Json;
 
     static bool s_restoreInProgress;
 };
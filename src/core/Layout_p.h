@@ -12,17 +12,36 @@
 #pragma once
 
 #include "Layout.h"
+#include "Group.h"
+#include "layouting/Item_p.h"
+#include "layouting/LayoutingGuest_p.h"
 #include "layouting/LayoutingHost_p.h"
 #include "kdbindings/signal.h"
 
 namespace KDDockWidgets::Core {
 
+template<typename Visitor>
+bool Layout::visitGroups(Visitor &&visitor) const
+{
+    return rootItem()->visit_recursive([&visitor](Item *item) {
+        // Skips groups whose view is already being destroyed
+        LayoutingGuest *guest = item->guest();
+        if (!guest || guest->freed())
+            return true;
+
+        if (Group *group = Group::fromItem(item))
+            return invokeVisitor(visitor, group);
+        return true;
+    });
+}
+
 class Layout::Private : public LayoutingHost
 {
 public:
     explicit Private(Layout *);
     ~Private() override;
     bool supportsHonouringLayoutMinSize() const override;
+    int maxPooledSeparators() const override;
 
     Layout *const q;
     bool m_inResizeEvent = false;
@@ -50,7 +50,7 @@ void MDILayout::addDockWidget(Core::DockWidget *dw, Point localPt,
     if (group) {
         newItem->setGuest(group->asLayoutingGuest());
     } else {
-        group = new Core::Group();
+        group = Core::Group::create();
         group->addTab(dw, addingOption);
 
         newItem->setGuest(group->asLayoutingGuest());
@@ -117,3 +117,25 @@ void MDILayout::resizeDockWidget(Core::Group *group, Size size)
 
     item->setSize(size.expandedTo(group->view()->minSize()));
 }
+
+void MDILayout::raiseGroup(Core::Group *group)
+{
+    if (!group)
+        return;
+
+    if (Core::Item *item = itemForFrame(group))
+        m_rootItem->raise(item);
+
+    group->view()->raise();
+}
+
+Vector<Core::Group *> MDILayout::groupsInZOrder() const
+{
+    Vector<Core::Group *> groups;
+    for (Core::Item *item : m_rootItem->itemsInZOrder()) {
+        if (Core::Group *group = Core::Group::fromItem(item))
+            groups.push_back(group);
+    }
+
+    return groups;
+}
@@ -57,6 +57,12 @@ public:
     /// @brief sets the size and position of the dock widget @p group
     void setDockWidgetGeometry(Core::Group *group, Rect);
 
+    /// @brief Brings @p group to the front, both in the layout's z-order and on screen
+    void raiseGroup(Core::Group *group);
+
+    /// @brief Returns the groups, the one at the back first
+    Vector<Core::Group *> groupsInZOrder() const;
+
 private:
     Core::ItemFreeContainer *const m_rootItem;
 };
@@ -25,6 +25,7 @@
 #include "core/MDILayout.h"
 #include "core/DropArea.h"
 #include "core/Utils_p.h"
+#include "core/JsonWriter_p.h"
 #include "core/Logging_p.h"
 #include "core/ScopedValueRollback_p.h"
 #include "core/WidgetResizeHandler_p.h"
@@ -728,6 +729,49 @@ LayoutSaver::MainWindow MainWindow::serialize() const
     return m;
 }
 
+void MainWindow::serialize(JsonWriter &writer) const
+{
+    // Same JSON as serialize() + to_json(), keys sorted like nlohmann::json does
+    Window::Ptr window = view()->window();
+
+    writer.beginObject();
+    writer.key("affinities");
+    writer.value(d->affinities);
+    writer.key("geometry");
+    writer.value(d->windowGeometry());
+    writer.key("isVisible");
+    writer.value(isVisible());
+    writer.key("multiSplitterLayout");
+    layout()->serialize(writer);
+    writer.key("normalGeometry");
+    writer.value(view()->normalGeometry());
+    writer.key("options");
+    writer.value(int(options()));
+    writer.key("screenIndex");
+    writer.value(Platform::instance()->screenNumberFor(view()));
+    writer.key("screenSize");
+    writer.value(Platform::instance()->screenSizeFor(view()));
+
+    // "sidebar-1" to "sidebar-4", already in alphabetical order
+    for (SideBarLocation loc : { SideBarLocation::North, SideBarLocation::East,
+                                 SideBarLocation::West, SideBarLocation::South }) {
+        if (Core::SideBar *sb = sideBar(loc)) {
+            const Vector<QString> dockwidgets = sb->serialize();
+            if (!dockwidgets.isEmpty()) {
+                const std::string key = std::string("sidebar-") + std::to_string(( int )loc);
+                writer.key(key.c_str());
+                writer.value(dockwidgets);
+            }
+        }
+    }
+
+    writer.key("uniqueName");
+    writer.value(uniqueName());
+    writer.key("windowState");
+    writer.value(int(window ? window->windowState() : WindowState::None));
+    writer.endObject();
+}
+
 void MainWindow::setPersistentCentralView(std::shared_ptr<View> widget)
 {
     if (!d->supportsPersistentCentralWidget()) {
@@ -47,6 +47,7 @@ class MainWindowViewInterface;
 class MDILayout;
 class DropArea;
 class Group;
+class JsonWriter;
 class Layout;
 class SideBar;
 class DockWidget;
@@ -257,6 +258,7 @@ private:
     friend class KDDockWidgets::LayoutSaver;
     bool deserialize(const LayoutSaver::MainWindow &);
     LayoutSaver::MainWindow serialize() const;
+    void serialize(JsonWriter &) const;
 };
 }
 }
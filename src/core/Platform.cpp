@@ -12,6 +12,7 @@
 #include "core/Platform.h"
 #include "core/Platform_p.h"
 #include "core/Logging_p.h"
+#include "core/DelayedCall_p.h"
 #include "core/Window_p.h"
 #include "core/Utils_p.h"
 #include "core/EventFilterInterface.h"
@@ -136,6 +137,12 @@ int Platform::startDragDistance_impl() const
     return 4;
 }
 
+void Platform::runOnMainThread(Core::DelayedCall *c)
+{
+    KDDW_ERROR("Platform::runOnMainThread: Not implemented by this frontend");
+    delete c;
+}
+
 /**static*/
 std::vector<KDDockWidgets::FrontendType> Platform::frontendTypes()
 {
@@ -239,14 +246,12 @@ void Platform::tests_deinitPlatform()
 
 void Platform::installGlobalEventFilter(EventFilterInterface *filter)
 {
-    d->m_globalEventFilters.push_back(filter);
+    d->m_globalEventFilters.add(filter);
 }
 
 void Platform::removeGlobalEventFilter(EventFilterInterface *filter)
 {
-    d->m_globalEventFilters.erase(
-        std::remove(d->m_globalEventFilters.begin(), d->m_globalEventFilters.end(), filter),
-        d->m_globalEventFilters.end());
+    d->m_globalEventFilters.remove(filter);
 }
 
 void Platform::onFloatingWindowCreated(Core::FloatingWindow *)
@@ -306,6 +306,12 @@ protected:
 
     Platform(const Platform &) = delete;
     Platform &operator=(const Platform &) = delete;
+
+public:
+    /// Runs @p c on the GUI thread once the event loop gets to it, then deletes it.
+    /// Unlike runDelayed(), can be called from any thread. Used by LayoutSaver::restoreLayoutAsync().
+    /// The default implementation only prints an error.
+    virtual void runOnMainThread(Core::DelayedCall *c);
 };
 
 #if defined(DOCKS_DEVELOPER_MODE)
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "core/Platform.h"
+#include "core/EventFilterList_p.h"
 #include "kdbindings/signal.h"
 
 #include <memory>
@@ -19,8 +20,6 @@
 
 namespace KDDockWidgets::Core {
 
-class EventFilterInterface;
-
 class Platform::Private
 {
 public:
@@ -42,7 +41,7 @@ public:
 
     bool m_inDestruction = false;
 
-    std::vector<EventFilterInterface *> m_globalEventFilters;
+    EventFilterList m_globalEventFilters;
 };
 
 }
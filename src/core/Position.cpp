@@ -17,6 +17,7 @@
 
 #include "Position_p.h"
 #include "LayoutSaver_p.h"
+#include "JsonWriter_p.h"
 #include "Logging_p.h"
 #include "ScopedValueRollback_p.h"
 #include "core/layouting/Item_p.h"
@@ -31,6 +32,33 @@
 
 using namespace KDDockWidgets;
 
+/// Returns the index of @p item in layout->items(), without building the list
+static int indexOfItem(Core::Layout *layout, const Core::Item *item)
+{
+    int index = 0;
+    const bool found = !layout->rootItem()->visit_recursive([item, &index](Core::Item *it) {
+        if (it == item)
+            return false;
+        ++index;
+        return true;
+    });
+
+    return found ? index : -1;
+}
+
+/// Returns the item at @p index in layout->items(), without building the list
+static Core::Item *itemAtIndex(Core::Layout *layout, int index)
+{
+    Core::Item *result = nullptr;
+    layout->rootItem()->visit_recursive([&result, &index](Core::Item *it) {
+        if (index-- == 0)
+            result = it;
+        return !result;
+    });
+
+    return result;
+}
+
 Position::~Position()
 {
     m_placeholders.clear();
@@ -164,9 +192,7 @@ void Position::deserialize(const LayoutSaver::Position &lp)
             layout = mainWindow->layout();
         }
 
-        const Core::Item::List &items = layout->items();
-        if (itemIndex >= 0 && itemIndex < items.size()) {
-            Core::Item *item = items.at(itemIndex);
+        if (Core::Item *item = itemIndex >= 0 ? itemAtIndex(layout, itemIndex) : nullptr) {
             addPlaceholderItem(item);
         } else {
             // Shouldn't happen, maybe even assert
@@ -187,7 +213,7 @@ LayoutSaver::Position Position::serialize() const
 
         Core::Item *item = itemRef->item;
         Core::Layout *layout = DockRegistry::self()->layoutForItem(item);
-        const auto itemIndex = layout->items().indexOf(item);
+        const auto itemIndex = indexOfItem(layout, item);
 
         auto fw = layout->floatingWindow();
         auto mainWindow = layout->mainWindow(/*honourNesting=*/true);
@@ -217,6 +243,65 @@ LayoutSaver::Position Position::serialize() const
     return l;
 }
 
+void Position::serialize(Core::JsonWriter &writer) const
+{
+    // Same JSON as serialize() + to_json(), keys sorted like nlohmann::json does
+    writer.beginObject();
+
+    writer.key("lastFloatingGeometry");
+    writer.value(lastFloatingGeometry());
+
+    // nlohmann::json writes maps with non-string keys as an array of [key, value] pairs
+    writer.key("lastOverlayedGeometries");
+    writer.beginArray();
+    for (const auto &it : m_lastOverlayedGeometries) {
+        writer.beginArray();
+        writer.value(int(it.first));
+        writer.value(it.second);
+        writer.endArray();
+    }
+    writer.endArray();
+
+    writer.key("placeholders");
+    writer.beginArray();
+    for (auto &itemRef : m_placeholders) {
+        Core::Item *item = itemRef->item;
+        Core::Layout *layout = DockRegistry::self()->layoutForItem(item);
+        const auto itemIndex = indexOfItem(layout, item);
+
+        auto fw = layout->floatingWindow();
+        auto mainWindow = layout->mainWindow(/*honourNesting=*/true);
+        assert(mainWindow || fw);
+
+        writer.beginObject();
+        if (fw) {
+            writer.key("indexOfFloatingWindow");
+            writer.value(fw->beingDeleted() ? -1 : int(DockRegistry::self()->floatingWindows().indexOf(fw)));
+            writer.key("isFloatingWindow");
+            writer.value(true);
+            writer.key("itemIndex");
+            writer.value(int(itemIndex));
+        } else {
+            assert(!mainWindow->uniqueName().isEmpty());
+            writer.key("isFloatingWindow");
+            writer.value(false);
+            writer.key("itemIndex");
+            writer.value(int(itemIndex));
+            writer.key("mainWindowUniqueName");
+            writer.value(mainWindow->uniqueName());
+        }
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.key("tabIndex");
+    writer.value(m_tabIndex);
+    writer.key("wasFloating");
+    writer.value(m_wasFloating);
+
+    writer.endObject();
+}
+
 ItemRef::ItemRef(KDBindings::ConnectionHandle conn, Core::Item *it)
     : item(it)
     , connection(std::move(conn))
@@ -33,6 +33,7 @@ namespace Core {
 class Item;
 class DockWidget;
 class Group;
+class JsonWriter;
 class Layout;
 class LayoutingHost;
 }
@@ -69,6 +70,7 @@ public:
 
     void deserialize(const LayoutSaver::Position &);
     LayoutSaver::Position serialize() const;
+    void serialize(Core::JsonWriter &) const;
 
     /**
      * @brief Returns whether the Position is valid. If invalid then the DockWidget was never
@@ -70,8 +70,27 @@ struct Separator::Private : public LayoutingSeparator
         delete q;
     }
 
+    void setPooled(bool pooled) override
+    {
+        if (pooled == isPooled)
+            return;
+
+        isPooled = pooled;
+        if (pooled) {
+            s_numSeparators--;
+            if (lazyResizeRubberBand)
+                lazyResizeRubberBand->hide();
+            q->setVisible(false);
+        } else {
+            s_numSeparators++;
+            // So the next setGeometry() isn't a no-op and shows us again
+            m_geometry = {};
+        }
+    }
+
     Core::Separator *const q;
     Rect m_geometry;
+    bool isPooled = false;
     int lazyPosition = 0;
     View *lazyResizeRubberBand = nullptr;
     const bool usesLazyResize = Config::self().flags() & Config::Flag_LazyResize;
@@ -280,5 +299,6 @@ int Separator::numSeparators()
 
 Separator::Private::~Private()
 {
-    s_numSeparators--;
+    if (!isPooled)
+        s_numSeparators--;
 }
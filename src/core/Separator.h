@@ -49,7 +49,8 @@ public:
     static bool isResizing();
 
     /// @internal Just for the unit-tests.
-    /// Returns the total amount of Separator() instances currently alive.
+    /// Returns the total amount of Separator() instances currently in use by a layout.
+    /// Hidden ones, pooled for reuse, aren't counted.
     static int numSeparators();
 
 public:
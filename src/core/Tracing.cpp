@@ -0,0 +1,245 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "Tracing_p.h"
+
+#ifdef KDDW_TRACING
+
+#include "JsonWriter_p.h"
+#include "Logging_p.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+std::atomic<bool> Tracer::s_enabled = false;
+
+namespace {
+
+/// 64K spans. A power of two, so the slot is the index's low bits.
+constexpr std::size_t s_capacity = 1 << 16;
+
+struct Span
+{
+    const char *name;
+    int64_t startNs;
+    int64_t durationNs;
+    uint32_t threadId;
+};
+
+/// A span in the ring buffer. Recording doesn't take a lock: each record() claims the next
+/// index atomically and fills its slot. The slot's sequence is the index it holds plus one,
+/// or 0 while it's being written, so readers can skip slots that are being overwritten.
+/// Fields are relaxed atomics, which compile to plain loads and stores.
+struct Slot
+{
+    std::atomic<uint64_t> sequence = 0;
+    std::atomic<const char *> name = nullptr;
+    std::atomic<int64_t> startNs = 0;
+    std::atomic<int64_t> durationNs = 0;
+    std::atomic<uint32_t> threadId = 0;
+};
+
+struct RingBuffer
+{
+    std::mutex allocationMutex; ///< Only taken by setEnabled()
+    std::unique_ptr<Slot[]> storage;
+    std::atomic<Slot *> slots = nullptr;
+    std::atomic<uint64_t> next = 0; ///< Index of the next span. Never wraps.
+    std::atomic<uint64_t> first = 0; ///< Index of the oldest span clear() kept
+};
+
+RingBuffer &ringBuffer()
+{
+    static RingBuffer buffer;
+    return buffer;
+}
+
+std::atomic<uint32_t> s_nextThreadId = 1;
+
+/// Small sequential ids read better in the trace viewers than hashed std::thread::ids
+uint32_t currentThreadId()
+{
+    thread_local const uint32_t id = s_nextThreadId++;
+    return id;
+}
+
+std::string traceFileFromEnvironment()
+{
+#ifdef _MSC_VER
+    char *value = nullptr;
+    std::size_t size = 0;
+    if (_dupenv_s(&value, &size, "KDDW_TRACE_FILE") != 0 || !value)
+        return {};
+
+    std::string result(value);
+    free(value);
+    return result;
+#else
+    const char *value = std::getenv("KDDW_TRACE_FILE");
+    return value ? value : std::string();
+#endif
+}
+
+/// Implements KDDW_TRACE_FILE
+struct TraceFile
+{
+    TraceFile()
+        : filename(traceFileFromEnvironment())
+    {
+        if (!filename.empty())
+            Tracer::setEnabled(true);
+    }
+
+    ~TraceFile()
+    {
+        if (!filename.empty())
+            Tracer::writeChromeTrace(QString::fromStdString(filename));
+    }
+
+    KDDW_DELETE_COPY_CTOR(TraceFile)
+
+    const std::string filename;
+};
+
+TraceFile s_traceFile;
+
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    RingBuffer &buffer = ringBuffer();
+    std::lock_guard<std::mutex> lock(buffer.allocationMutex);
+    if (enabled && !buffer.storage) {
+        buffer.storage.reset(new Slot[s_capacity]);
+        buffer.slots.store(buffer.storage.get(), std::memory_order_release);
+    }
+
+    s_enabled = enabled;
+}
+
+void Tracer::clear()
+{
+    RingBuffer &buffer = ringBuffer();
+    buffer.first.store(buffer.next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+std::size_t Tracer::spanCount()
+{
+    RingBuffer &buffer = ringBuffer();
+    const uint64_t count = buffer.next.load(std::memory_order_relaxed) - buffer.first.load(std::memory_order_relaxed);
+    return std::size_t(std::min<uint64_t>(count, s_capacity));
+}
+
+int64_t Tracer::now()
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point s_epoch = steady_clock::now();
+    return duration_cast<nanoseconds>(steady_clock::now() - s_epoch).count();
+}
+
+void Tracer::record(const char *name, int64_t startNs, int64_t endNs)
+{
+    RingBuffer &buffer = ringBuffer();
+    Slot *slots = buffer.slots.load(std::memory_order_acquire);
+    if (!slots)
+        return;
+
+    const uint64_t index = buffer.next.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[index & (s_capacity - 1)];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(endNs - startNs, std::memory_order_relaxed);
+    slot.threadId.store(currentThreadId(), std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::writeChromeTrace(const std::function<void(const char *, std::size_t)> &sink)
+{
+    // Copied first, spans being recorded meanwhile are skipped
+    std::vector<Span> spans;
+    RingBuffer &buffer = ringBuffer();
+    if (Slot *slots = buffer.slots.load(std::memory_order_acquire)) {
+        const uint64_t end = buffer.next.load(std::memory_order_acquire);
+        const uint64_t first = std::max(buffer.first.load(std::memory_order_relaxed),
+                                        end > s_capacity ? end - s_capacity : 0);
+        spans.reserve(std::size_t(end - first));
+        for (uint64_t index = first; index < end; ++index) {
+            const Slot &slot = slots[index & (s_capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+                continue;
+
+            const Span span = { slot.name.load(std::memory_order_relaxed),
+                                slot.startNs.load(std::memory_order_relaxed),
+                                slot.durationNs.load(std::memory_order_relaxed),
+                                slot.threadId.load(std::memory_order_relaxed) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == index + 1)
+                spans.push_back(span);
+        }
+    }
+
+    JsonWriter writer(sink);
+    writer.beginObject();
+    writer.key("displayTimeUnit");
+    writer.value(QStringLiteral("ms"));
+    writer.key("traceEvents");
+    writer.beginArray();
+    for (const Span &span : spans) {
+        // "Complete" events. Timestamps are in microseconds.
+        writer.beginObject();
+        writer.key("cat");
+        writer.value(QStringLiteral("kddw"));
+        writer.key("dur");
+        writer.value(double(span.durationNs) / 1000.0);
+        writer.key("name");
+        writer.value(QString::fromUtf8(span.name));
+        writer.key("ph");
+        writer.value(QStringLiteral("X"));
+        writer.key("pid");
+        writer.value(1);
+        writer.key("tid");
+        writer.value(int(span.threadId));
+        writer.key("ts");
+        writer.value(double(span.startNs) / 1000.0);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+bool Tracer::writeChromeTrace(const QString &filename)
+{
+    std::ofstream file(filename.toStdString(), std::ios::binary);
+    if (!file.is_open()) {
+        KDDW_ERROR("Failed to open {}", filename);
+        return false;
+    }
+
+    writeChromeTrace([&file](const char *data, std::size_t size) {
+        file.write(data, std::streamsize(size));
+    });
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+/// Low overhead tracing of hot paths, for debugging jank.
+///
+/// Build with -DKDDockWidgets_TRACING=ON to enable it. Otherwise KDDW_TRACE_SCOPE() compiles to
+/// nothing. Spans are kept in a ring buffer and can be exported in the Chrome trace event format,
+/// which chrome://tracing and https://ui.perfetto.dev open.
+///
+/// Recording is off by default. Setting the KDDW_TRACE_FILE environment variable turns it on at
+/// startup and writes the trace to that file when the application exits.
+
+#ifdef KDDW_TRACING
+
+#include "KDDockWidgets.h"
+#include "QtCompat_p.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace KDDockWidgets::Core {
+
+class DOCKS_EXPORT Tracer
+{
+public:
+    /// Starts or stops recording spans
+    static void setEnabled(bool);
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Forgets all recorded spans
+    static void clear();
+
+    /// Number of spans in the ring buffer. The oldest ones are dropped once it's full.
+    static std::size_t spanCount();
+
+    /// Writes the recorded spans, in the Chrome trace event JSON format, to @p sink
+    static void writeChromeTrace(const std::function<void(const char *, std::size_t)> &sink);
+    static bool writeChromeTrace(const QString &filename);
+
+    /// Nanoseconds since the first call
+    static int64_t now();
+
+    /// Records a span. @p name needs to outlive the tracer, usually a string literal.
+    /// Doesn't take a lock, so threads recording at the same time don't wait for each other.
+    static void record(const char *name, int64_t startNs, int64_t endNs);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/// Records a span from construction until destruction. Use KDDW_TRACE_SCOPE().
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : m_name(name)
+        , m_startNs(Tracer::isEnabled() ? Tracer::now() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_startNs >= 0)
+            Tracer::record(m_name, m_startNs, Tracer::now());
+    }
+
+    KDDW_DELETE_COPY_CTOR(TraceScope)
+
+private:
+    const char *const m_name;
+    const int64_t m_startNs;
+};
+
+}
+
+#define KDDW_TRACE_CONCAT_IMPL(a, b) a##b
+#define KDDW_TRACE_CONCAT(a, b) KDDW_TRACE_CONCAT_IMPL(a, b)
+
+/// Traces the rest of the current scope. @p name must be a string literal.
+#define KDDW_TRACE_SCOPE(name) \
+    const KDDockWidgets::Core::TraceScope KDDW_TRACE_CONCAT(kddwTraceScope, __LINE__)("" name "")
+
+#else
+
+#define KDDW_TRACE_SCOPE(name) (( void )0)
+
+#endif
@@ -401,6 +401,11 @@ Rect View::Private::globalGeometry() const
     return geo;
 }
 
+void View::updateRect(Rect)
+{
+    update();
+}
+
 void View::createPlatformWindow()
 {
     // Only qtwidgets need this
@@ -441,48 +446,21 @@ bool View::equals(const View *one, const View *two)
 
 void View::installViewEventFilter(EventFilterInterface *filter)
 {
-    d->m_viewEventFilters.push_back(filter);
+    d->m_viewEventFilters.add(filter);
 }
 
 void View::removeViewEventFilter(EventFilterInterface *filter)
 {
-    d->m_viewEventFilters.erase(
-        std::remove(d->m_viewEventFilters.begin(), d->m_viewEventFilters.end(), filter),
-        d->m_viewEventFilters.end());
+    d->m_viewEventFilters.remove(filter);
 }
 
 bool View::deliverViewEventToFilters(Event *ev)
 {
-    for (Core::EventFilterInterface *filter : std::as_const(d->m_viewEventFilters)) {
-        if (ev->type() == Event::Move) {
-            if (filter->onMoveEvent(this))
-                return true;
-        } else if (auto me = mouseEvent(ev)) {
-            if (filter->onMouseEvent(this, me))
-                return true;
-
-            switch (ev->type()) {
-            case Event::MouseButtonPress:
-                if (filter->onMouseButtonPress(this, me))
-                    return true;
-                break;
-            case Event::MouseButtonRelease:
-                if (filter->onMouseButtonRelease(this, me))
-                    return true;
-                break;
-            case Event::MouseMove:
-                if (filter->onMouseButtonMove(this, me))
-                    return true;
-                break;
-            case Event::MouseButtonDblClick:
-                if (filter->onMouseDoubleClick(this, me))
-                    return true;
-                break;
-            default:
-                break;
-            }
-        }
-    }
+    if (ev->type() == Event::Move)
+        return d->m_viewEventFilters.deliverMoveEvent(this);
+
+    if (auto me = mouseEvent(ev))
+        return d->m_viewEventFilters.deliverMouseEvent(this, me);
 
     return false;
 }
@@ -184,6 +184,10 @@ public:
     /// @Returns a list of child views
     virtual Vector<std::shared_ptr<View>> childViews() const = 0;
 
+    /// Schedules repainting only @p rect, in local coordinates.
+    /// Frontends which can't repaint partially repaint the whole view.
+    virtual void updateRect(Rect rect);
+
     /// @brief Returns whether the DTOR is currently running. freed() might be true while inDtor
     /// false, as the implementation of free() is free to delay it (with deleteLater() for example)
     bool inDtor() const;
@@ -13,6 +13,7 @@
 
 #include "kddockwidgets/docks_export.h"
 #include "core/View.h"
+#include "core/EventFilterList_p.h"
 #include "kdbindings/signal.h"
 #include "QtCompat_p.h"
 
@@ -23,7 +24,6 @@ namespace KDDockWidgets {
 
 namespace Core {
 
-class EventFilterInterface;
 class DOCKS_EXPORT_FOR_UNIT_TESTS View::Private
 {
 public:
@@ -47,7 +47,7 @@ public:
     KDBindings::Signal<Size> resized;
 
     /// List of event filters
-    std::vector<EventFilterInterface *> m_viewEventFilters;
+    EventFilterList m_viewEventFilters;
 
     /// @brief Returns the views's geometry, but always in global space
     Rect globalGeometry() const;
@@ -103,6 +103,11 @@ int WidgetResizeHandler::widgetResizeHandlerMargin()
     return 4; // pixels
 }
 
+EventFilterInterface::EventTypes WidgetResizeHandler::eventTypes() const
+{
+    return EventType_Mouse;
+}
+
 bool WidgetResizeHandler::onMouseEvent(View *widget, MouseEvent *e)
 {
     if (s_disableAllHandlers || !widget || !mTargetGuard)
@@ -155,6 +155,7 @@ public:
 
 private:
     // EventFilterInterface:
+    EventTypes eventTypes() const override;
     bool onMouseEvent(Core::View *, MouseEvent *) override;
     void setTarget(Core::View *w);
     bool mouseMoveEvent(MouseEvent *);
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 
 using namespace KDDockWidgets;
 using namespace KDDockWidgets::Core;
@@ -26,6 +27,16 @@ double SegmentedDropIndicatorOverlay::s_draggedWindowOpacity = 0.7;
 int SegmentedDropIndicatorOverlay::s_centralIndicatorMaxWidth = 300;
 int SegmentedDropIndicatorOverlay::s_centralIndicatorMaxHeight = 160;
 
+namespace {
+/// The indicators updateSegments() considers, outer ones first
+constexpr DropLocation s_indicators[] = {
+    DropLocation_OutterLeft, DropLocation_OutterRight, DropLocation_OutterTop,
+    DropLocation_OutterBottom, DropLocation_Left, DropLocation_Top,
+    DropLocation_Right, DropLocation_Bottom, DropLocation_Center
+};
+constexpr std::size_t s_numOutterIndicators = 4;
+}
+
 SegmentedDropIndicatorOverlay::SegmentedDropIndicatorOverlay(Core::DropArea *dropArea)
     : DropIndicatorOverlay(dropArea, Config::self().viewFactory()->createSegmentedDropIndicatorOverlayView(this, dropArea->view()))
 {
@@ -43,8 +54,18 @@ SegmentedDropIndicatorOverlay::~SegmentedDropIndicatorOverlay() = default;
 DropLocation SegmentedDropIndicatorOverlay::hover_impl(Point pt)
 {
     m_hoveredPt = view()->mapFromGlobal(pt);
-    updateSegments();
-    setCurrentDropLocation(dropLocationForPos(m_hoveredPt));
+    const DropLocation previouslyHighlighted = m_highlightedLocation;
+    const bool segmentsChanged = updateSegments();
+    m_highlightedLocation = dropLocationForPos(m_hoveredPt);
+    setCurrentDropLocation(m_highlightedLocation);
+
+    if (segmentsChanged) {
+        view()->update();
+    } else if (m_highlightedLocation != previouslyHighlighted) {
+        // Only the segment losing the highlight and the one gaining it need repainting
+        updateSegment(previouslyHighlighted);
+        updateSegment(m_highlightedLocation);
+    }
 
     return currentDropLocation();
 }
@@ -127,15 +148,31 @@ std::unordered_map<DropLocation, Polygon> SegmentedDropIndicatorOverlay::segment
              { DropLocation_OutterBottom, bottomPoints } };
 }
 
-void SegmentedDropIndicatorOverlay::updateSegments()
+bool SegmentedDropIndicatorOverlay::updateSegments()
 {
+    // Queried on every hover, as it depends on more than the hovered group, for example on
+    // Config::dropIndicatorAllowedFunc()
+    SegmentsKey key = { rect(), hoveredGroupRect(), 0, true };
+    for (std::size_t i = 0; i < std::size(s_indicators); ++i) {
+        if (dropIndicatorVisible(s_indicators[i]))
+            key.visibleIndicators |= 1u << i;
+    }
+
+    if (key == m_segmentsKey)
+        return false;
+
+    m_segmentsKey = key;
     m_segments.clear();
 
+    auto isVisible = [&key](std::size_t index) {
+        return (key.visibleIndicators & (1u << index)) != 0;
+    };
+
     const auto outterSegments = segmentsForRect(rect(), /*inner=*/false);
 
-    for (auto indicator : { DropLocation_OutterLeft, DropLocation_OutterRight,
-                            DropLocation_OutterTop, DropLocation_OutterBottom }) {
-        if (dropIndicatorVisible(indicator)) {
+    for (std::size_t i = 0; i < s_numOutterIndicators; ++i) {
+        if (isVisible(i)) {
+            const DropLocation indicator = s_indicators[i];
             auto it = outterSegments.find(indicator);
             const Polygon segment = it == outterSegments.cend() ? Polygon() : it->second;
             m_segments[indicator] = segment;
@@ -146,16 +183,27 @@ void SegmentedDropIndicatorOverlay::updateSegments()
     const bool useOffset = hasOutter;
     const auto innerSegments = segmentsForRect(hoveredGroupRect(), /*inner=*/true, useOffset);
 
-    for (auto indicator : { DropLocation_Left, DropLocation_Top, DropLocation_Right,
-                            DropLocation_Bottom, DropLocation_Center }) {
-        if (dropIndicatorVisible(indicator)) {
+    for (std::size_t i = s_numOutterIndicators; i < std::size(s_indicators); ++i) {
+        if (isVisible(i)) {
+            const DropLocation indicator = s_indicators[i];
             auto it = innerSegments.find(indicator);
             const Polygon segment = it == innerSegments.cend() ? Polygon() : it->second;
             m_segments[indicator] = segment;
         }
     }
 
-    view()->update();
+    return true;
+}
+
+void SegmentedDropIndicatorOverlay::updateSegment(DropLocation location)
+{
+    auto it = m_segments.find(location);
+    if (it == m_segments.cend() || it->second.isEmpty())
+        return;
+
+    // The outline is drawn centered on the polygon's edges, and antialiased
+    const int margin = s_segmentPenWidth;
+    view()->updateRect(it->second.boundingRect().adjusted(-margin, -margin, margin, margin));
 }
 
 Point SegmentedDropIndicatorOverlay::posForIndicator(DropLocation) const
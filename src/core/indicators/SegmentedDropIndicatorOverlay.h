@@ -14,6 +14,7 @@
 #include <kddockwidgets/QtCompat_p.h>
 #include <kddockwidgets/core/DropIndicatorOverlay.h>
 
+#include <cstdint>
 #include <unordered_map>
 
 namespace KDDockWidgets {
@@ -42,10 +43,33 @@ protected:
     Point posForIndicator(DropLocation) const override;
 
 private:
+    /// What the segments are computed from. They're only recomputed when it changes.
+    struct SegmentsKey
+    {
+        Rect overlayRect;
+        Rect hoveredGroupRect;
+        uint32_t visibleIndicators = 0; ///< one bit per indicator shown
+        bool isValid = false;
+
+        bool operator==(const SegmentsKey &other) const
+        {
+            return isValid == other.isValid && visibleIndicators == other.visibleIndicators
+                && overlayRect == other.overlayRect && hoveredGroupRect == other.hoveredGroupRect;
+        }
+    };
+
     std::unordered_map<DropLocation, Polygon> segmentsForRect(Rect, bool inner, bool useOffset = false) const;
-    void updateSegments();
+
+    /// Returns whether the segments changed
+    bool updateSegments();
+
+    /// Repaints the segment at @p location, which might have changed color
+    void updateSegment(DropLocation location);
+
     Point m_hoveredPt = {};
     std::unordered_map<DropLocation, Polygon> m_segments;
+    SegmentsKey m_segmentsKey;
+    DropLocation m_highlightedLocation = DropLocation_None;
 };
 
 }
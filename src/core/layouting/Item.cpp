@@ -15,15 +15,19 @@
 #include "LayoutingGuest_p.h"
 #include "LayoutingSeparator_p.h"
 
+#include "core/JsonWriter_p.h"
 #include "core/Logging_p.h"
 #include "core/ObjectGuard_p.h"
 #include "core/ScopedValueRollback_p.h"
+#include "core/Tracing_p.h"
 #include "core/nlohmann_helpers_p.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <cstdlib>
 #include <utility>
+#include <vector>
 
 #ifdef KDDW_FRONTEND_QT
 #include "core/Platform_p.h"
@@ -58,6 +62,69 @@ Size Core::Item::hardcodedMaximumSize = Size(16777215, 16777215);
 bool Core::ItemBoxContainer::s_inhibitSimplify = false;
 LayoutingSeparator *LayoutingSeparator::s_separatorBeingDragged = nullptr;
 
+/// Bumped whenever something that the containers' min/max sizes depend on changes:
+/// children, their visibility, their min/max sizes or the container orientation.
+/// See ItemBoxContainer::minSize()
+/// Unsigned and 64-bit, so it can't overflow. Starts at 1, caches use 0 for "never computed".
+static uint64_t s_sizeConstraintsGeneration = 1;
+
+/// Bumped whenever the layout changes in any way. See Item::layoutGeneration()
+/// Same as above, starts at 1 so caches can use 0 for "never computed".
+static uint64_t s_layoutGeneration = 1;
+
+inline void invalidateSizeConstraints()
+{
+    ++s_sizeConstraintsGeneration;
+    ++s_layoutGeneration;
+}
+
+namespace {
+
+/// Borrows a list from a pool and returns it, cleared but with its capacity intact, when going
+/// out of scope. Nested scopes get different lists.
+/// Used by the code paths that run for every mouse move while dragging a separator, so they
+/// don't allocate temporary lists.
+template<typename List>
+class ScratchList
+{
+public:
+    ScratchList()
+    {
+        auto &pool = freeLists();
+        if (pool.empty()) {
+            m_list = std::make_unique<List>();
+        } else {
+            m_list = std::move(pool.back());
+            pool.pop_back();
+        }
+    }
+
+    ~ScratchList()
+    {
+        m_list->clear();
+        freeLists().push_back(std::move(m_list));
+    }
+
+    ScratchList(const ScratchList &) = delete;
+    ScratchList &operator=(const ScratchList &) = delete;
+
+    List &operator*()
+    {
+        return *m_list;
+    }
+
+private:
+    static std::vector<std::unique_ptr<List>> &freeLists()
+    {
+        thread_local std::vector<std::unique_ptr<List>> s_freeLists;
+        return s_freeLists;
+    }
+
+    std::unique_ptr<List> m_list;
+};
+
+}
+
 inline bool locationIsVertical(Location loc)
 {
     return loc == Location_OnTop || loc == Location_OnBottom;
@@ -226,13 +293,6 @@ void Item::setGuest(LayoutingGuest *guest)
     updateObjectName();
 }
 
-void Item::updateWidgetGeometries()
-{
-    if (m_guest) {
-        m_guest->setGeometry(mapToRoot(rect()));
-    }
-}
-
 void Item::to_json(nlohmann::json &json) const
 {
     json["sizingInfo"] = m_sizingInfo;
@@ -243,11 +303,46 @@ void Item::to_json(nlohmann::json &json) const
         json["guestId"] = m_guest->id(); // just for coorelation purposes when restoring
 }
 
+/// Streaming version of to_json(nlohmann::json &, const SizingInfo &)
+static void serializeSizingInfo(JsonWriter &writer, const SizingInfo &info)
+{
+    writer.beginObject();
+    writer.key("geometry");
+    writer.value(info.geometry);
+    writer.key("maxSizeHint");
+    writer.value(info.maxSizeHint);
+    writer.key("minSize");
+    writer.value(info.minSize);
+    writer.key("percentageWithinParent");
+    writer.value(info.percentageWithinParent);
+    writer.endObject();
+}
+
+void Item::serialize(JsonWriter &writer) const
+{
+    // Same keys as above, in the alphabetical order nlohmann::json sorts them
+    writer.beginObject();
+    if (m_guest) {
+        writer.key("guestId");
+        writer.value(m_guest->id());
+    }
+    writer.key("isContainer");
+    writer.value(isContainer());
+    writer.key("isVisible");
+    writer.value(m_isVisible);
+    writer.key("objectName");
+    writer.value(objectName());
+    writer.key("sizingInfo");
+    serializeSizingInfo(writer, m_sizingInfo);
+    writer.endObject();
+}
+
 void Item::fillFromJson(const nlohmann::json &j,
                         const std::unordered_map<QString, LayoutingGuest *> &widgets)
 {
     m_sizingInfo = j.value("sizingInfo", SizingInfo());
     m_isVisible = j.value("isVisible", false);
+    invalidateSizeConstraints();
     setObjectName(j.value("objectName", QString()));
     const QString guestId = j.value("guestId", QString());
     if (!guestId.isEmpty()) {
@@ -389,6 +484,7 @@ bool Item::isBeingInserted() const
 void Item::setBeingInserted(bool is)
 {
     m_sizingInfo.isBeingInserted = is;
+    invalidateSizeConstraints();
 
     // Trickle up the hierarchy too, as the parent might be hidden due to not having visible
     // children
@@ -423,6 +519,7 @@ void Item::setParentContainer(ItemContainer *parent)
     }
 
     m_parent = parent;
+    invalidateSizeConstraints();
     connectParent(parent); // Reused by the ctor too
 
     setParent(parent);
@@ -504,6 +601,7 @@ void Item::setMinSize(Size sz)
 {
     if (sz != m_sizingInfo.minSize) {
         m_sizingInfo.minSize = sz;
+        invalidateSizeConstraints();
         minSizeChanged.emit(this);
         if (!m_isSettingGuest)
             setSize_recursive(size().expandedTo(sz));
@@ -514,6 +612,7 @@ void Item::setMaxSizeHint(Size sz)
 {
     if (sz != m_sizingInfo.maxSizeHint) {
         m_sizingInfo.maxSizeHint = sz;
+        invalidateSizeConstraints();
         maxSizeChanged.emit(this);
     }
 }
@@ -713,6 +812,7 @@ void Item::setIsVisible(bool is)
 {
     if (is != m_isVisible) {
         m_isVisible = is;
+        invalidateSizeConstraints();
         visibleChanged.emit(this, is);
     }
 
@@ -767,6 +867,11 @@ bool Item::checkSanity()
     return true;
 }
 
+uint64_t Item::layoutGeneration()
+{
+    return s_layoutGeneration;
+}
+
 bool Item::isMDI() const
 {
     return object_cast<ItemFreeContainer *>(parentContainer()) != nullptr;
@@ -780,6 +885,7 @@ void Item::setGeometry(Rect rect)
         const Rect oldGeo = m_geometry;
 
         m_geometry = rect;
+        ++s_layoutGeneration;
 
         if (rect.isEmpty()) {
             // Just a sanity check...
@@ -814,6 +920,9 @@ void Item::setGeometry(Rect rect)
         if (oldGeo.height() != height())
             heightChanged.emit();
 
+        if (m_parent)
+            m_parent->onChildGeometryChanged(this);
+
         updateWidgetGeometries();
     }
 }
@@ -1025,10 +1134,13 @@ struct ItemBoxContainer::Private
     ~Private()
     {
         for (const auto &sep : std::as_const(m_separators))
-            sep->free();
+            releaseSeparator(sep);
         m_separators.clear();
     }
 
+    /// Gives @p sep back to its host's pool
+    static void releaseSeparator(LayoutingSeparator *sep);
+
     int defaultLengthFor(Item *item, InitialOption option) const;
     void relayoutIfNeeded();
     const Item *itemFromPath(const Vector<int> &path) const;
@@ -1043,17 +1155,30 @@ struct ItemBoxContainer::Private
     void updateWidgets_recursive();
     /// Returns the positions that each separator should have (x position if Qt::Horizontal, y
     /// otherwise)
-    Vector<int> requiredSeparatorPositions() const;
+    void requiredSeparatorPositions(Vector<int> &positions) const;
     void updateSeparators();
     void deleteSeparators();
     LayoutingSeparator *separatorAt(int p) const;
     Vector<double> childPercentages() const;
+    void childPercentages(Vector<double> &percentages) const;
     bool isDummy() const;
     void deleteSeparators_recursive();
     void updateSeparators_recursive();
     Size minSize(const Item::List &items) const;
     int excessLength() const;
 
+    /// Returns whether a LayoutTransaction is open on our root. If so, it's marked as having
+    /// pending updates, which will be applied when it ends.
+    bool deferToTransaction();
+    void applyPendingUpdates_recursive();
+
+    /// Marks our separators and our children's positions as needing an update, so
+    /// updateSeparators_recursive() and positionItems_recursive() visit us
+    void setDirty();
+
+    Size maxSizeHint() const;
+    bool canCacheSizeConstraints() const;
+
     mutable bool m_checkSanityScheduled = false;
     Vector<LayoutingSeparator *> m_separators;
     bool m_convertingItemToContainer = false;
@@ -1061,6 +1186,41 @@ struct ItemBoxContainer::Private
     bool m_isDeserializing = false;
     bool m_isSimplifying = false;
     Qt::Orientation m_orientation = Qt::Vertical;
+
+    // Only used by the root container, see LayoutTransaction
+    int m_transactionDepth = 0;
+    bool m_transactionHasPendingUpdates = false;
+
+    bool m_hasPendingSeparatorUpdate = false;
+
+    // Dirty flags, so updateSeparators_recursive() and positionItems_recursive() only visit the
+    // affected sub-trees. Each walk clears its own pair, as they don't always run together.
+    bool m_separatorsDirty = true;
+    bool m_hasDirtyDescendant = false;
+    bool m_positionsDirty = true;
+    bool m_hasDirtyPositionsDescendant = false;
+    Point m_separatorsGlobalPos; // Our position in root when the separators were last updated
+
+    // The min-size we last notified our parent about
+    Size m_lastNotifiedMinSize = { -1, -1 };
+
+    // See ItemBoxContainer::minSize()
+    mutable Size m_cachedMinSize;
+    mutable Size m_cachedMaxSizeHint;
+    mutable uint64_t m_minSizeCacheGeneration = 0;
+    mutable uint64_t m_maxSizeHintCacheGeneration = 0;
+
+    /// The visible children and where each one starts along our orientation, in layout order.
+    /// Lets itemAt() binary search, see visibleChildrenByPos()
+    struct ChildPos
+    {
+        int pos;
+        Item *item;
+    };
+    const std::vector<ChildPos> &visibleChildrenByPos() const;
+    mutable std::vector<ChildPos> m_visibleChildrenByPos;
+    mutable uint64_t m_visibleChildrenByPosGeneration = 0;
+
     ItemBoxContainer *const q;
 };
 
@@ -1126,6 +1286,11 @@ bool ItemBoxContainer::checkSanity()
         return true;
     }
 
+    if (root()->d->m_transactionDepth > 0) {
+        // Separators and guests are only updated when the transaction ends
+        return true;
+    }
+
     if (!Item::checkSanity())
         return false;
 
@@ -1315,6 +1480,7 @@ void ItemBoxContainer::restore(Item *child)
 
 void ItemBoxContainer::removeItem(Item *item, bool hardRemove)
 {
+    KDDW_TRACE_SCOPE("ItemBoxContainer::removeItem");
     assert(!item->isRoot());
 
     if (!contains(item)) {
@@ -1338,6 +1504,7 @@ void ItemBoxContainer::removeItem(Item *item, bool hardRemove)
 
     if (hardRemove) {
         m_children.removeOne(item);
+        invalidateSizeConstraints();
         delete item;
         if (!isContainer)
             root()->numItemsChanged.emit();
@@ -1394,6 +1561,7 @@ ItemBoxContainer *ItemBoxContainer::convertChildToContainer(Item *leaf)
 
     insertItem(container, index, DefaultSizeMode::NoDefaultSizeMode);
     m_children.removeOne(leaf);
+    invalidateSizeConstraints();
     container->setGeometry(leaf->geometry());
     container->insertItem(leaf, Location_OnTop, DefaultSizeMode::NoDefaultSizeMode);
     itemsChanged.emit();
@@ -1462,6 +1630,7 @@ void ItemBoxContainer::insertItem(Item *item, Location loc,
         if (m_children.size() == 1) {
             // 2 items is the minimum to know which orientation we're layedout
             d->m_orientation = locOrientation;
+            invalidateSizeConstraints();
         }
 
         const auto index = locationIsSide1(loc) ? 0 : m_children.size();
@@ -1473,6 +1642,7 @@ void ItemBoxContainer::insertItem(Item *item, Location loc,
         container->setGeometry(rect());
         container->setChildren(m_children, d->m_orientation);
         m_children.clear();
+        invalidateSizeConstraints();
         setOrientation(oppositeOrientation(d->m_orientation));
         insertItem(container, 0, DefaultSizeMode::NoDefaultSizeMode);
 
@@ -1528,9 +1698,26 @@ void ItemBoxContainer::updateSizeConstraints()
     }
 
     // Our min-size changed, notify our parent, and so on until it reaches root()
+    // If it didn't change, then our ancestors aren't affected and don't need to be visited
+    const Size minSize = this->minSize();
+    if (minSize == d->m_lastNotifiedMinSize)
+        return;
+
+    d->m_lastNotifiedMinSize = minSize;
     minSizeChanged.emit(this);
 }
 
+void ItemBoxContainer::onChildGeometryChanged(Item *child)
+{
+    // Our separators depend on our children's geometry. If the child is a container,
+    // its separators depend on its own geometry too
+    d->setDirty();
+    if (child->isContainer()) {
+        if (auto c = child->asBoxContainer())
+            c->d->setDirty();
+    }
+}
+
 void ItemBoxContainer::onChildVisibleChanged(Item *, bool visible)
 {
     if (d->m_isDeserializing || isInSimplify())
@@ -1689,27 +1876,39 @@ Rect ItemBoxContainer::suggestedDropRectFallback(const Item *item, const Item *r
 
 void ItemBoxContainer::positionItems()
 {
-    SizingInfo::List sizes = this->sizes();
+    ScratchList<SizingInfo::List> scratch;
+    SizingInfo::List &sizes = this->sizes(*scratch);
     positionItems(/*by-ref=*/sizes);
     applyPositions(sizes);
 
+    // Cleared after applying, as moving our children marks us dirty again
+    d->m_positionsDirty = false;
+
     d->updateSeparators_recursive();
 }
 
 void ItemBoxContainer::positionItems_recursive()
 {
     positionItems();
+
+    // Only recurse into the children that changed. Repositioning a child container
+    // that didn't move or resize, and has no changed descendants, would be a no-op.
     for (Item *item : std::as_const(m_children)) {
         if (item->isVisible()) {
-            if (auto c = item->asBoxContainer())
-                c->positionItems_recursive();
+            if (auto c = item->asBoxContainer()) {
+                if (c->d->m_positionsDirty || c->d->m_hasDirtyPositionsDescendant)
+                    c->positionItems_recursive();
+            }
         }
     }
+
+    d->m_hasDirtyPositionsDescendant = false;
 }
 
 void ItemBoxContainer::applyPositions(const SizingInfo::List &sizes)
 {
-    const Item::List items = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &items = visibleChildren(*scratch);
     const auto count = items.size();
     assert(count == sizes.size());
     for (int i = 0; i < count; ++i) {
@@ -1765,13 +1964,45 @@ void ItemBoxContainer::clear()
         delete item;
     }
     m_children.clear();
+    invalidateSizeConstraints();
     d->deleteSeparators();
+
+    // Whatever replaces the children needs to notify its min size, even if it's the same as before
+    d->m_lastNotifiedMinSize = { -1, -1 };
+}
+
+const std::vector<ItemBoxContainer::Private::ChildPos> &
+ItemBoxContainer::Private::visibleChildrenByPos() const
+{
+    const uint64_t generation = Item::layoutGeneration();
+    if (m_visibleChildrenByPosGeneration != generation) {
+        // clear() keeps the capacity, so only layouts that grew allocate
+        m_visibleChildrenByPos.clear();
+        for (Item *item : std::as_const(q->m_children)) {
+            if (item->isVisible())
+                m_visibleChildrenByPos.push_back({ item->pos(m_orientation), item });
+        }
+        m_visibleChildrenByPosGeneration = generation;
+    }
+
+    return m_visibleChildrenByPos;
 }
 
 Item *ItemBoxContainer::itemAt(Point p) const
 {
-    for (Item *item : std::as_const(m_children)) {
-        if (item->isVisible() && item->geometry().contains(p))
+    // Visible children don't overlap and are laid out in order, so binary search for the last
+    // one starting before p
+    const auto &children = d->visibleChildrenByPos();
+    const int pos = Core::pos(p, d->m_orientation);
+    auto it = std::upper_bound(children.cbegin(), children.cend(), pos,
+                               [](int value, const Private::ChildPos &child) {
+                                   return value < child.pos;
+                               });
+
+    if (it != children.cbegin()) {
+        // Visibility was checked when caching, for containers it's a recursive query
+        Item *item = std::prev(it)->item;
+        if (item->geometry().contains(p))
             return item;
     }
 
@@ -1780,12 +2011,15 @@ Item *ItemBoxContainer::itemAt(Point p) const
 
 Item *ItemBoxContainer::itemAt_recursive(Point p) const
 {
-    if (Item *item = itemAt(p)) {
-        if (auto c = item->asBoxContainer()) {
-            return c->itemAt_recursive(c->mapFromParent(p));
-        } else {
+    // Iterative, descends one level per iteration
+    const ItemBoxContainer *container = this;
+    while (Item *item = container->itemAt(p)) {
+        auto c = item->asBoxContainer();
+        if (!c)
             return item;
-        }
+
+        p = c->mapFromParent(p);
+        container = c;
     }
 
     return nullptr;
@@ -1826,6 +2060,7 @@ void ItemBoxContainer::setLength_recursive(int length, Qt::Orientation o)
 
 void ItemBoxContainer::insertItem(Item *item, int index, InitialOption option)
 {
+    KDDW_TRACE_SCOPE("ItemBoxContainer::insertItem");
     if (option.sizeMode != DefaultSizeMode::NoDefaultSizeMode) {
         /// Choose a nice size for the item we're adding
         const int suggestedLength = d->defaultLengthFor(item, option);
@@ -1833,6 +2068,7 @@ void ItemBoxContainer::insertItem(Item *item, int index, InitialOption option)
     }
 
     m_children.insert(index, item);
+    invalidateSizeConstraints();
     item->setParentContainer(this);
 
     itemsChanged.emit();
@@ -1860,7 +2096,8 @@ bool ItemBoxContainer::hasOrientationFor(Location loc) const
 
 int ItemBoxContainer::usableLength() const
 {
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch);
     const auto numVisibleChildren = children.size();
 
     if (children.size() <= 1)
@@ -1873,6 +2110,7 @@ int ItemBoxContainer::usableLength() const
 void ItemBoxContainer::setChildren(const List &children, Qt::Orientation o)
 {
     m_children = children;
+    invalidateSizeConstraints();
     for (Item *item : children)
         item->setParentContainer(this);
 
@@ -1883,6 +2121,7 @@ void ItemBoxContainer::setOrientation(Qt::Orientation o)
 {
     if (o != d->m_orientation) {
         d->m_orientation = o;
+        invalidateSizeConstraints();
         d->updateSeparators_recursive();
     }
 }
@@ -1918,15 +2157,46 @@ Size ItemBoxContainer::Private::minSize(const Item::List &items) const
 
 Size ItemBoxContainer::minSize() const
 {
-    return d->minSize(m_children);
+    if (!d->canCacheSizeConstraints())
+        return d->minSize(m_children);
+
+    if (d->m_minSizeCacheGeneration != s_sizeConstraintsGeneration) {
+        d->m_cachedMinSize = d->minSize(m_children);
+        d->m_minSizeCacheGeneration = s_sizeConstraintsGeneration;
+    }
+
+    return d->m_cachedMinSize;
 }
 
 Size ItemBoxContainer::maxSizeHint() const
 {
-    int maxW = isVertical() ? hardcodedMaximumSize.width() : 0;
-    int maxH = isVertical() ? 0 : hardcodedMaximumSize.height();
+    if (!d->canCacheSizeConstraints())
+        return d->maxSizeHint();
+
+    if (d->m_maxSizeHintCacheGeneration != s_sizeConstraintsGeneration) {
+        d->m_cachedMaxSizeHint = d->maxSizeHint();
+        d->m_maxSizeHintCacheGeneration = s_sizeConstraintsGeneration;
+    }
 
-    const Item::List visibleChildren = this->visibleChildren(/*includeBeingInserted=*/false);
+    return d->m_cachedMaxSizeHint;
+}
+
+bool ItemBoxContainer::Private::canCacheSizeConstraints() const
+{
+    // Only while dragging a separator. The drag doesn't change any size constraint, but does query
+    // them many times per mouse move. Outside of a drag SizingInfo is sometimes written directly,
+    // bypassing invalidateSizeConstraints().
+    return LayoutingSeparator::s_separatorBeingDragged != nullptr;
+}
+
+Size ItemBoxContainer::Private::maxSizeHint() const
+{
+    const bool isVertical = q->isVertical();
+    int maxW = isVertical ? Item::hardcodedMaximumSize.width() : 0;
+    int maxH = isVertical ? 0 : Item::hardcodedMaximumSize.height();
+
+    ScratchList<Item::List> scratch;
+    const Item::List &visibleChildren = q->visibleChildren(*scratch, /*includeBeingInserted=*/false);
     if (!visibleChildren.isEmpty()) {
         for (Item *item : visibleChildren) {
             if (item->isBeingInserted())
@@ -1934,30 +2204,30 @@ Size ItemBoxContainer::maxSizeHint() const
             const Size itemMaxSz = item->maxSizeHint();
             const int itemMaxWidth = itemMaxSz.width();
             const int itemMaxHeight = itemMaxSz.height();
-            if (isVertical()) {
+            if (isVertical) {
                 maxW = std::min(maxW, itemMaxWidth);
-                maxH = std::min(maxH + itemMaxHeight, hardcodedMaximumSize.height());
+                maxH = std::min(maxH + itemMaxHeight, Item::hardcodedMaximumSize.height());
             } else {
                 maxH = std::min(maxH, itemMaxHeight);
-                maxW = std::min(maxW + itemMaxWidth, hardcodedMaximumSize.width());
+                maxW = std::min(maxW + itemMaxWidth, Item::hardcodedMaximumSize.width());
             }
         }
 
-        const auto separatorWaste = (int(visibleChildren.size()) - 1) * separatorThickness;
-        if (isVertical()) {
-            maxH = std::min(maxH + separatorWaste, hardcodedMaximumSize.height());
+        const auto separatorWaste = (int(visibleChildren.size()) - 1) * Item::separatorThickness;
+        if (isVertical) {
+            maxH = std::min(maxH + separatorWaste, Item::hardcodedMaximumSize.height());
         } else {
-            maxW = std::min(maxW + separatorWaste, hardcodedMaximumSize.width());
+            maxW = std::min(maxW + separatorWaste, Item::hardcodedMaximumSize.width());
         }
     }
 
     if (maxW == 0)
-        maxW = hardcodedMaximumSize.width();
+        maxW = Item::hardcodedMaximumSize.width();
 
     if (maxH == 0)
-        maxH = hardcodedMaximumSize.height();
+        maxH = Item::hardcodedMaximumSize.height();
 
-    return Size(maxW, maxH).expandedTo(d->minSize(visibleChildren));
+    return Size(maxW, maxH).expandedTo(minSize(visibleChildren));
 }
 
 void ItemBoxContainer::Private::resizeChildren(Size oldSize, Size newSize,
@@ -1969,7 +2239,9 @@ void ItemBoxContainer::Private::resizeChildren(Size oldSize, Size newSize,
     // The new sizes are applied to @p childSizes, which will be applied to the widgets when we're
     // done
 
-    const Vector<double> childPercentages = this->childPercentages();
+    ScratchList<Vector<double>> scratch;
+    Vector<double> &childPercentages = *scratch;
+    this->childPercentages(childPercentages);
     const auto count = childSizes.count();
     const bool widthChanged = oldSize.width() != newSize.width();
     const bool heightChanged = oldSize.height() != newSize.height();
@@ -2065,8 +2337,10 @@ void ItemBoxContainer::Private::honourMaxSizes(SizingInfo::List &sizes)
 
     int amountNeededToShrink = 0;
     int amountAvailableToGrow = 0;
-    Vector<int> indexesOfShrinkers;
-    Vector<int> indexesOfGrowers;
+    ScratchList<Vector<int>> shrinkersScratch;
+    ScratchList<Vector<int>> growersScratch;
+    Vector<int> &indexesOfShrinkers = *shrinkersScratch;
+    Vector<int> &indexesOfGrowers = *growersScratch;
 
     for (int i = 0; i < sizes.count(); ++i) {
         SizingInfo &info = sizes[i];
@@ -2159,6 +2433,7 @@ bool ItemBoxContainer::hostSupportsHonouringLayoutMinSize() const
 
 void ItemBoxContainer::setSize_recursive(Size newSize, ChildrenResizeStrategy strategy)
 {
+    KDDW_TRACE_SCOPE("ItemBoxContainer::setSize_recursive");
     ScopedValueRollback block(d->m_blockUpdatePercentages, true);
 
     const Size minSize = this->minSize();
@@ -2170,15 +2445,18 @@ void ItemBoxContainer::setSize_recursive(Size newSize, ChildrenResizeStrategy st
         return;
     }
 
+    // Sub-trees whose size didn't change are left untouched
     if (newSize == size())
         return;
 
     const Size oldSize = size();
     setSize(newSize);
 
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> childrenScratch;
+    const Item::List &children = visibleChildren(*childrenScratch);
     const auto count = children.size();
-    SizingInfo::List childSizes = sizes();
+    ScratchList<SizingInfo::List> sizesScratch;
+    SizingInfo::List &childSizes = sizes(*sizesScratch);
 
     // #1 Since we changed size, also resize out children.
     // But apply them to our SizingInfo::List first before setting actual Item/QWidget geometries
@@ -2284,13 +2562,17 @@ Vector<double> ItemBoxContainer::Private::childPercentages() const
 {
     Vector<double> percentages;
     percentages.reserve(q->m_children.size());
+    childPercentages(percentages);
+    return percentages;
+}
 
+void ItemBoxContainer::Private::childPercentages(Vector<double> &percentages) const
+{
+    percentages.clear();
     for (Item *item : std::as_const(q->m_children)) {
         if (item->isVisible() && !item->isBeingInserted())
             percentages.push_back(item->m_sizingInfo.percentageWithinParent);
     }
-
-    return percentages;
 }
 
 void ItemBoxContainer::restoreChild(Item *item, NeighbourSqueezeStrategy neighbourSqueezeStrategy)
@@ -2358,6 +2640,19 @@ void ItemBoxContainer::restoreChild(Item *item, NeighbourSqueezeStrategy neighbo
     d->updateSeparators_recursive();
 }
 
+void Item::updateWidgetGeometries()
+{
+    if (m_guest) {
+        auto r = root();
+        if (r && r->d->deferToTransaction()) {
+            m_hasPendingGuestGeometry = true;
+            return;
+        }
+
+        m_guest->setGeometry(mapToRoot(rect()));
+    }
+}
+
 void ItemBoxContainer::updateWidgetGeometries()
 {
     for (Item *item : std::as_const(m_children))
@@ -2372,6 +2667,7 @@ int ItemBoxContainer::oppositeLength() const
 void ItemBoxContainer::requestSeparatorMove(LayoutingSeparator *separator,
                                             int delta)
 {
+    KDDW_TRACE_SCOPE("ItemBoxContainer::requestSeparatorMove");
     const auto separatorIndex = d->m_separators.indexOf(separator);
     if (separatorIndex == -1) {
         // Doesn't happen
@@ -2399,7 +2695,8 @@ void ItemBoxContainer::requestSeparatorMove(LayoutingSeparator *separator,
     }
 
     const Side moveDirection = delta < 0 ? Side1 : Side2;
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch);
     if (children.size() <= separatorIndex) {
         // Doesn't happen
         KDDW_ERROR("Not enough children for separator index", ( void * )separator, ( void * )this, separatorIndex);
@@ -2543,7 +2840,7 @@ void ItemBoxContainer::layoutEqually(SizingInfo::List &sizes)
     Vector<int> satisfiedIndexes;
     satisfiedIndexes.reserve(numItems);
 
-    int lengthToGive = length() - (d->m_separators.size() * Item::separatorThickness);
+    int lengthToGive = length() - (std::max(0, int(numItems) - 1) * Item::separatorThickness);
 
     // clear the sizes before we start distributing
     for (SizingInfo &size : sizes) {
@@ -2615,6 +2912,7 @@ void ItemBoxContainer::layoutEqually(SizingInfo::List &sizes)
 
 void ItemBoxContainer::layoutEqually_recursive()
 {
+    KDDW_TRACE_SCOPE("ItemBoxContainer::layoutEqually_recursive");
     layoutEqually();
     for (Item *item : std::as_const(m_children)) {
         if (item->isVisible()) {
@@ -2688,7 +2986,8 @@ LengthOnSide ItemBoxContainer::lengthOnSide(const SizingInfo::List &sizes, int f
 
 int ItemBoxContainer::neighboursLengthFor(const Item *item, Side side, Qt::Orientation o) const
 {
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch);
     const auto index = children.indexOf(const_cast<Item *>(item));
     if (index == -1) {
         KDDW_ERROR("Couldn't find item {}", ( void * )item);
@@ -2726,7 +3025,8 @@ int ItemBoxContainer::neighboursLengthFor_recursive(const Item *item, Side side,
 
 int ItemBoxContainer::neighboursMinLengthFor(const Item *item, Side side, Qt::Orientation o) const
 {
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch);
     const auto index = children.indexOf(const_cast<Item *>(item));
     if (index == -1) {
         KDDW_ERROR("Couldn't find item {}", ( void * )item);
@@ -2757,7 +3057,8 @@ int ItemBoxContainer::neighboursMinLengthFor(const Item *item, Side side, Qt::Or
 
 int ItemBoxContainer::neighboursMaxLengthFor(const Item *item, Side side, Qt::Orientation o) const
 {
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch);
     const auto index = children.indexOf(const_cast<Item *>(item));
     if (index == -1) {
         KDDW_ERROR("Couldn't find item {}", ( void * )item);
@@ -3023,9 +3324,11 @@ void ItemBoxContainer::growItem(Item *item, int amount, GrowthStrategy growthStr
                                 bool accountForNewSeparator,
                                 ChildrenResizeStrategy childResizeStrategy)
 {
-    const Item::List items = visibleChildren();
+    ScratchList<Item::List> itemsScratch;
+    const Item::List &items = visibleChildren(*itemsScratch);
     const auto index = items.indexOf(item);
-    SizingInfo::List sizes = this->sizes();
+    ScratchList<SizingInfo::List> sizesScratch;
+    SizingInfo::List &sizes = this->sizes(*sizesScratch);
 
     growItem(index, /*by-ref=*/sizes, amount, growthStrategy, neighbourSqueezeStrategy,
              accountForNewSeparator);
@@ -3036,7 +3339,8 @@ void ItemBoxContainer::growItem(Item *item, int amount, GrowthStrategy growthStr
 void ItemBoxContainer::applyGeometries(const SizingInfo::List &sizes,
                                        ChildrenResizeStrategy strategy)
 {
-    const Item::List items = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &items = visibleChildren(*scratch);
     const auto count = items.size();
     assert(count == sizes.size());
 
@@ -3050,9 +3354,17 @@ void ItemBoxContainer::applyGeometries(const SizingInfo::List &sizes,
 
 SizingInfo::List ItemBoxContainer::sizes(bool ignoreBeingInserted) const
 {
-    const Item::List children = visibleChildren(ignoreBeingInserted);
     SizingInfo::List result;
-    result.reserve(children.count());
+    result.reserve(m_children.size());
+    sizes(result, ignoreBeingInserted);
+    return result;
+}
+
+SizingInfo::List &ItemBoxContainer::sizes(SizingInfo::List &result, bool ignoreBeingInserted) const
+{
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch, ignoreBeingInserted);
+    result.clear();
     for (Item *item : children) {
         if (item->isContainer()) {
             // Containers have virtual min/maxSize methods, and don't really fill in these
@@ -3066,19 +3378,19 @@ SizingInfo::List ItemBoxContainer::sizes(bool ignoreBeingInserted) const
     return result;
 }
 
-Vector<int> ItemBoxContainer::calculateSqueezes(
+void ItemBoxContainer::calculateSqueezes(
     SizingInfo::List::const_iterator begin, // clazy:exclude=function-args-by-ref
     SizingInfo::List::const_iterator end, int needed, // clazy:exclude=function-args-by-ref
-    NeighbourSqueezeStrategy strategy, bool reversed) const
+    NeighbourSqueezeStrategy strategy, Vector<int> &squeezes, bool reversed) const
 {
-    Vector<int> availabilities;
+    ScratchList<Vector<int>> scratch;
+    Vector<int> &availabilities = *scratch;
     for (auto it = begin; it < end; ++it) {
         availabilities.push_back(it->availableLength(d->m_orientation));
     }
 
     const auto count = availabilities.count();
 
-    Vector<int> squeezes;
     squeezes.resize(count);
     std::fill(squeezes.begin(), squeezes.end(), 0);
 
@@ -3092,7 +3404,8 @@ Vector<int> ItemBoxContainer::calculateSqueezes(
             if (numDonors == 0) {
                 root()->dumpLayout();
                 assert(false);
-                return {};
+                squeezes.clear();
+                return;
             }
 
             int toTake = missing / numDonors;
@@ -3131,8 +3444,6 @@ Vector<int> ItemBoxContainer::calculateSqueezes(
         // Doesn't really happen
         KDDW_ERROR("Missing is negative. missing={}, squeezes={}", missing, squeezes);
     }
-
-    return squeezes;
 }
 
 void ItemBoxContainer::shrinkNeighbours(int index, SizingInfo::List &sizes, int side1Amount,
@@ -3145,8 +3456,9 @@ void ItemBoxContainer::shrinkNeighbours(int index, SizingInfo::List &sizes, int
         auto begin = sizes.cbegin();
         auto end = sizes.cbegin() + index;
         const bool reversed = strategy == NeighbourSqueezeStrategy::ImmediateNeighboursFirst;
-        const Vector<int> squeezes =
-            calculateSqueezes(begin, end, side1Amount, strategy, reversed);
+        ScratchList<Vector<int>> scratch;
+        Vector<int> &squeezes = *scratch;
+        calculateSqueezes(begin, end, side1Amount, strategy, squeezes, reversed);
         for (int i = 0; i < squeezes.size(); ++i) {
             const int squeeze = squeezes.at(i);
             SizingInfo &sizing = sizes[i];
@@ -3160,7 +3472,9 @@ void ItemBoxContainer::shrinkNeighbours(int index, SizingInfo::List &sizes, int
         auto begin = sizes.cbegin() + index + 1;
         auto end = sizes.cend();
 
-        const Vector<int> squeezes = calculateSqueezes(begin, end, side2Amount, strategy);
+        ScratchList<Vector<int>> scratch;
+        Vector<int> &squeezes = *scratch;
+        calculateSqueezes(begin, end, side2Amount, strategy, squeezes);
         for (int i = 0; i < squeezes.size(); ++i) {
             const int squeeze = squeezes.at(i);
             SizingInfo &sizing = sizes[i + index + 1];
@@ -3169,11 +3483,10 @@ void ItemBoxContainer::shrinkNeighbours(int index, SizingInfo::List &sizes, int
     }
 }
 
-Vector<int> ItemBoxContainer::Private::requiredSeparatorPositions() const
+void ItemBoxContainer::Private::requiredSeparatorPositions(Vector<int> &positions) const
 {
     const int numSeparators = std::max(0, q->numVisibleChildren() - 1);
-    Vector<int> positions;
-    positions.reserve(numSeparators);
+    positions.clear();
 
     for (Item *item : std::as_const(q->m_children)) {
         if (positions.size() == numSeparators)
@@ -3184,8 +3497,6 @@ Vector<int> ItemBoxContainer::Private::requiredSeparatorPositions() const
             positions.push_back(q->mapToRoot(localPos, m_orientation));
         }
     }
-
-    return positions;
 }
 
 void ItemBoxContainer::Private::updateSeparators()
@@ -3193,7 +3504,21 @@ void ItemBoxContainer::Private::updateSeparators()
     if (!q->host())
         return;
 
-    const Vector<int> positions = requiredSeparatorPositions();
+    if (deferToTransaction()) {
+        m_hasPendingSeparatorUpdate = true;
+        q->updateChildPercentages();
+        return;
+    }
+
+    if (!m_separators.isEmpty() && m_separators.constFirst()->orientation() != m_orientation) {
+        // Our orientation changed while a LayoutTransaction deferred the separator update.
+        // Separators can't change orientation, replace them.
+        deleteSeparators();
+    }
+
+    ScratchList<Vector<int>> scratch;
+    Vector<int> &positions = *scratch;
+    requiredSeparatorPositions(positions);
     const auto requiredNumSeparators = positions.size();
 
     const bool numSeparatorsChanged = requiredNumSeparators != m_separators.size();
@@ -3207,17 +3532,22 @@ void ItemBoxContainer::Private::updateSeparators()
             LayoutingSeparator *separator = separatorAt(position);
             if (separator) {
                 // Already existing, reuse
-                newSeparators.push_back(separator);
                 m_separators.removeOne(separator);
-            } else {
-                separator = s_createSeparatorFunc(q->host(), m_orientation, q);
-                newSeparators.push_back(separator);
             }
+            newSeparators.push_back(separator);
         }
 
-        // delete what remained, which is unused
+        // Pool what remained, which is unused. Then fill the gaps from the pool, so those are
+        // recycled before creating new ones.
         deleteSeparators();
 
+        for (LayoutingSeparator *&separator : newSeparators) {
+            if (!separator)
+                separator = q->host()->takePooledSeparator(m_orientation, q);
+            if (!separator)
+                separator = s_createSeparatorFunc(q->host(), m_orientation, q);
+        }
+
         m_separators = newSeparators;
     }
 
@@ -3234,11 +3564,21 @@ void ItemBoxContainer::Private::updateSeparators()
     q->updateChildPercentages();
 }
 
+void ItemBoxContainer::Private::releaseSeparator(LayoutingSeparator *sep)
+{
+    // The separator's host, not ours, as we might have just been moved to another host
+    if (sep->m_host)
+        sep->m_host->releaseSeparator(sep);
+    else
+        sep->free();
+}
+
 void ItemBoxContainer::Private::deleteSeparators()
 {
     for (const auto &sep : std::as_const(m_separators))
-        sep->free();
+        releaseSeparator(sep);
     m_separators.clear();
+    setDirty();
 }
 
 void ItemBoxContainer::Private::deleteSeparators_recursive()
@@ -3254,13 +3594,61 @@ void ItemBoxContainer::Private::deleteSeparators_recursive()
 
 void ItemBoxContainer::Private::updateSeparators_recursive()
 {
+    // Separators have global coordinates, if we moved then all descendants need updating
+    const Point globalPos = q->mapToRoot(Point(0, 0));
+    const bool moved = globalPos != m_separatorsGlobalPos;
+    m_separatorsGlobalPos = globalPos;
+
     updateSeparators();
+    m_separatorsDirty = false;
+    m_hasDirtyDescendant = false;
 
-    // recurse into the children:
-    const Item::List items = q->visibleChildren();
-    for (Item *item : items) {
-        if (auto c = item->asBoxContainer())
-            c->d->updateSeparators_recursive();
+    // recurse into the children, but only the ones that changed
+    for (Item *item : std::as_const(q->m_children)) {
+        if (!item->isContainer() || !item->isVisible() || item->isBeingInserted())
+            continue;
+
+        if (auto c = item->asBoxContainer()) {
+            if (moved || c->d->m_separatorsDirty || c->d->m_hasDirtyDescendant)
+                c->d->updateSeparators_recursive();
+        }
+    }
+}
+
+void ItemBoxContainer::Private::setDirty()
+{
+    m_separatorsDirty = true;
+    m_positionsDirty = true;
+    for (ItemBoxContainer *p = q->parentBoxContainer(); p; p = p->parentBoxContainer()) {
+        p->d->m_hasDirtyDescendant = true;
+        p->d->m_hasDirtyPositionsDescendant = true;
+    }
+}
+
+bool ItemBoxContainer::Private::deferToTransaction()
+{
+    ItemBoxContainer *root = q->root();
+    if (!root || root->d->m_transactionDepth == 0)
+        return false;
+
+    root->d->m_transactionHasPendingUpdates = true;
+    return true;
+}
+
+void ItemBoxContainer::Private::applyPendingUpdates_recursive()
+{
+    if (m_hasPendingSeparatorUpdate) {
+        m_hasPendingSeparatorUpdate = false;
+        updateSeparators();
+    }
+
+    for (Item *item : std::as_const(q->m_children)) {
+        if (auto c = item->asBoxContainer()) {
+            c->d->applyPendingUpdates_recursive();
+        } else if (item->m_hasPendingGuestGeometry) {
+            item->m_hasPendingGuestGeometry = false;
+            item->updateWidgetGeometries();
+        }
     }
 }
 
@@ -3305,6 +3693,7 @@ void ItemBoxContainer::simplify()
 
     if (m_children != newChildren) {
         m_children = newChildren;
+        invalidateSizeConstraints();
         positionItems();
         updateChildPercentages();
     }
@@ -3364,7 +3753,8 @@ int ItemBoxContainer::minPosForSeparator_global(LayoutingSeparator *separator,
     const int separatorIndex = indexOf(separator);
     assert(separatorIndex != -1);
 
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch);
     assert(separatorIndex + 1 < children.size());
     Item *item2 = children.at(separatorIndex + 1);
 
@@ -3388,7 +3778,8 @@ int ItemBoxContainer::maxPosForSeparator_global(LayoutingSeparator *separator,
     const int separatorIndex = indexOf(separator);
     assert(separatorIndex != -1);
 
-    const Item::List children = visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = visibleChildren(*scratch);
     Item *item1 = children.at(separatorIndex);
 
     const int availableToSqueeze =
@@ -3413,6 +3804,31 @@ void ItemBoxContainer::to_json(nlohmann::json &j) const
     j["orientation"] = d->m_orientation;
 }
 
+void ItemBoxContainer::serialize(JsonWriter &writer) const
+{
+    writer.beginObject();
+    writer.key("children");
+    writer.beginArray();
+    for (Item *child : std::as_const(m_children))
+        child->serialize(writer);
+    writer.endArray();
+    if (m_guest) {
+        writer.key("guestId");
+        writer.value(m_guest->id());
+    }
+    writer.key("isContainer");
+    writer.value(isContainer());
+    writer.key("isVisible");
+    writer.value(m_isVisible);
+    writer.key("objectName");
+    writer.value(objectName());
+    writer.key("orientation");
+    writer.value(int(d->m_orientation));
+    writer.key("sizingInfo");
+    serializeSizingInfo(writer, m_sizingInfo);
+    writer.endObject();
+}
+
 void ItemBoxContainer::fillFromJson(const nlohmann::json &j,
                                     const std::unordered_map<QString, LayoutingGuest *> &widgets)
 {
@@ -3424,6 +3840,9 @@ void ItemBoxContainer::fillFromJson(const nlohmann::json &j,
     ScopedValueRollback deserializing(d->m_isDeserializing, true);
     Item::fillFromJson(j, widgets);
 
+    // Our children are being replaced, see clear()
+    d->m_lastNotifiedMinSize = { -1, -1 };
+
     d->m_orientation = Qt::Orientation(j.value<Qt::Orientation>("orientation", {}));
 
     for (const auto &child : j.value("children", nlohmann::json::array())) {
@@ -3434,7 +3853,10 @@ void ItemBoxContainer::fillFromJson(const nlohmann::json &j,
         m_children.push_back(childItem);
     }
 
+    invalidateSizeConstraints();
+
     if (isRoot()) {
+        LayoutTransaction transaction(this);
         updateChildPercentages_recursive();
         if (host()) {
             d->updateSeparators_recursive();
@@ -3444,9 +3866,11 @@ void ItemBoxContainer::fillFromJson(const nlohmann::json &j,
         d->relayoutIfNeeded();
         positionItems_recursive();
 
+        d->m_lastNotifiedMinSize = minSize();
         minSizeChanged.emit(this);
+        transaction.commit();
 #ifdef DOCKS_DEVELOPER_MODE
-        if (!checkSanity())
+        if (!s_silenceSanityChecks && !checkSanity())
             KDDW_ERROR("Resulting layout is invalid");
 #endif
     }
@@ -3508,12 +3932,13 @@ bool ItemBoxContainer::test_suggestedRect()
 
 Vector<LayoutingSeparator *> ItemBoxContainer::separators_recursive() const
 {
+    // Appends into a single list, instead of merging one list per nested container
     LayoutingSeparator::List separators = d->m_separators;
-
-    for (Item *item : std::as_const(m_children)) {
+    auto appendSeparators = [&separators](Item *item) {
         if (auto c = item->asBoxContainer())
-            separators.append(c->separators_recursive());
-    }
+            separators.append(c->d->m_separators);
+    };
+    visit_recursive(appendSeparators, VisitFilter::Containers);
 
     return separators;
 }
@@ -3696,7 +4121,8 @@ LayoutingSeparator *
 ItemBoxContainer::Private::neighbourSeparator(const Item *item, Side side,
                                               Qt::Orientation orientation) const
 {
-    Item::List children = q->visibleChildren();
+    ScratchList<Item::List> scratch;
+    const Item::List &children = q->visibleChildren(*scratch);
     const auto itemIndex = children.indexOf(const_cast<Item *>(item));
     if (itemIndex == -1) {
         KDDW_ERROR("Item not found item={}, this={}", ( void * )item, ( void * )this);
@@ -3941,46 +4367,74 @@ bool ItemContainer::contains(const Item *item) const
 
 Item *ItemContainer::itemForView(const LayoutingGuest *w) const
 {
-    for (Item *item : std::as_const(m_children)) {
-        if (item->isContainer()) {
-            if (Item *result = item->asContainer()->itemForView(w))
-                return result;
-        } else if (item->guest() == w) {
-            return item;
+    // The guest already points to its item, we only need to check the item is ours.
+    // Walks up the item's ancestors instead of searching the whole tree.
+    Item *result = w ? w->layoutItem() : nullptr;
+    if (result && result->guest() != w)
+        result = nullptr;
+
+    if (result) {
+        ItemContainer *ancestor = result->parentContainer();
+        while (ancestor && ancestor != this)
+            ancestor = ancestor->parentContainer();
+
+        if (!ancestor)
+            result = nullptr;
+    }
+
+#ifdef DOCKS_DEVELOPER_MODE
+    if (w) {
+        Item *expected = nullptr;
+        visit_recursive([w, &expected](Item *item) {
+            if (item->guest() != w)
+                return true;
+
+            expected = item;
+            return false;
+        });
+
+        if (result != expected) {
+            KDDW_ERROR("ItemContainer::itemForView: Guest points to the wrong item. guest={}, item={}, expected={}",
+                       ( void * )w, ( void * )result, ( void * )expected);
+            return expected;
         }
     }
+#endif
 
-    return nullptr;
+    return result;
 }
 
 Item::List ItemContainer::visibleChildren(bool includeBeingInserted) const
 {
     Item::List items;
     items.reserve(m_children.size());
+    visibleChildren(items, includeBeingInserted);
+    return items;
+}
+
+Item::List &ItemContainer::visibleChildren(Item::List &result, bool includeBeingInserted) const
+{
+    result.clear();
     for (Item *item : std::as_const(m_children)) {
         if (includeBeingInserted) {
             if (item->isVisible() || item->isBeingInserted())
-                items.push_back(item);
+                result.push_back(item);
         } else {
             if (item->isVisible() && !item->isBeingInserted())
-                items.push_back(item);
+                result.push_back(item);
         }
     }
 
-    return items;
+    return result;
 }
 
 Item::List ItemContainer::items_recursive() const
 {
     Item::List items;
     items.reserve(30); // sounds like a good upper number to minimize allocations
-    for (Item *item : std::as_const(m_children)) {
-        if (auto c = item->asContainer()) {
-            items.append(c->items_recursive());
-        } else {
-            items.push_back(item);
-        }
-    }
+    visit_recursive([&items](Item *item) {
+        items.push_back(item);
+    });
 
     return items;
 }
@@ -4024,7 +4478,87 @@ int ItemContainer::count_recursive() const
     return count;
 }
 
-LayoutingHost::~LayoutingHost() = default;
+LayoutingHost::~LayoutingHost()
+{
+    clearSeparatorPool();
+}
+
+Vector<LayoutingSeparator *> &LayoutingHost::pooledSeparators(Qt::Orientation orientation)
+{
+    return orientation == Qt::Vertical ? m_pooledVerticalSeparators : m_pooledHorizontalSeparators;
+}
+
+LayoutingSeparator *LayoutingHost::takePooledSeparator(Qt::Orientation orientation, ItemBoxContainer *container)
+{
+    auto &pool = pooledSeparators(orientation);
+    if (pool.isEmpty())
+        return nullptr;
+
+    LayoutingSeparator *separator = pool.takeLast();
+    separator->m_parentContainer = container;
+    separator->setPooled(false);
+
+    m_separatorPoolStats.available--;
+    m_separatorPoolStats.reused++;
+
+    return separator;
+}
+
+void LayoutingHost::releaseSeparator(LayoutingSeparator *separator)
+{
+    if (LayoutingSeparator::s_separatorBeingDragged == separator)
+        LayoutingSeparator::s_separatorBeingDragged = nullptr;
+
+    // Capped, otherwise a large restore would keep all its separators alive until the host dies
+    const int maxPooled = maxPooledSeparators();
+    if (m_separatorPoolStats.available >= maxPooled) {
+        // The cap might have been lowered after the pool filled up
+        trimSeparatorPool(maxPooled);
+        m_separatorPoolStats.discarded++;
+        separator->free();
+        return;
+    }
+
+    separator->m_parentContainer = nullptr;
+    separator->setPooled(true);
+    pooledSeparators(separator->orientation()).push_back(separator);
+
+    m_separatorPoolStats.available++;
+    m_separatorPoolStats.peak = std::max(m_separatorPoolStats.peak, m_separatorPoolStats.available);
+}
+
+void LayoutingHost::trimSeparatorPool(int max)
+{
+    while (m_separatorPoolStats.available > max) {
+        auto &pool = m_pooledHorizontalSeparators.size() > m_pooledVerticalSeparators.size()
+            ? m_pooledHorizontalSeparators
+            : m_pooledVerticalSeparators;
+        pool.takeLast()->free();
+        m_separatorPoolStats.available--;
+        m_separatorPoolStats.discarded++;
+    }
+}
+
+int LayoutingHost::maxPooledSeparators() const
+{
+    return 32;
+}
+
+void LayoutingHost::clearSeparatorPool()
+{
+    for (auto pool : { &m_pooledHorizontalSeparators, &m_pooledVerticalSeparators }) {
+        for (LayoutingSeparator *separator : std::as_const(*pool))
+            separator->free();
+        pool->clear();
+    }
+
+    m_separatorPoolStats.available = 0;
+}
+
+LayoutingHost::SeparatorPoolStats LayoutingHost::separatorPoolStats() const
+{
+    return m_separatorPoolStats;
+}
 LayoutingSeparator::~LayoutingSeparator() = default;
 
 LayoutingSeparator::LayoutingSeparator(LayoutingHost *host, Qt::Orientation orientation, Core::ItemBoxContainer *container)
@@ -4077,6 +4611,10 @@ void LayoutingSeparator::free()
     delete this;
 }
 
+void LayoutingSeparator::setPooled(bool)
+{
+}
+
 bool LayoutingSeparator::isBeingDragged() const
 {
     return LayoutingSeparator::s_separatorBeingDragged != nullptr;
@@ -4085,6 +4623,9 @@ bool LayoutingSeparator::isBeingDragged() const
 void LayoutingSeparator::onMousePress()
 {
     LayoutingSeparator::s_separatorBeingDragged = this;
+
+    // Start with fresh min/max sizes, as they're cached during the drag
+    invalidateSizeConstraints();
 }
 
 void LayoutingSeparator::onMouseRelease()
@@ -4119,6 +4660,36 @@ int LayoutingSeparator::onMouseMove(Point pos, bool moveSeparator)
     return positionToGoTo;
 }
 
+LayoutTransaction::LayoutTransaction(Item *item)
+    : m_root(item ? item->root() : nullptr)
+{
+    if (m_root)
+        m_root->d->m_transactionDepth++;
+}
+
+LayoutTransaction::~LayoutTransaction()
+{
+    commit();
+}
+
+void LayoutTransaction::commit()
+{
+    if (!m_root)
+        return;
+
+    ItemBoxContainer *root = m_root;
+    m_root = nullptr;
+
+    auto d = root->d;
+    d->m_transactionDepth--;
+    if (d->m_transactionDepth > 0 || !d->m_transactionHasPendingUpdates)
+        return;
+
+    d->m_transactionHasPendingUpdates = false;
+    d->applyPendingUpdates_recursive();
+    d->scheduleCheckSanity();
+}
+
 class LayoutingGuest::Private
 {
 public:
@@ -16,20 +16,47 @@
 #include "core/Logging_p.h"
 #include "core/Utils_p.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
 using namespace KDDockWidgets::Core;
 
+struct ItemFreeContainer::Private
+{
+    uint64_t zFor(const Item *item) const
+    {
+        auto it = m_z.find(item);
+        return it == m_z.cend() ? 0 : it->second;
+    }
+
+    void sortByZ(Item::List &items) const
+    {
+        std::sort(items.begin(), items.end(), [this](const Item *a, const Item *b) {
+            return zFor(a) < zFor(b);
+        });
+    }
+
+    /// Higher is in front
+    std::unordered_map<const Item *, uint64_t> m_z;
+    uint64_t m_lastZ = 0;
+};
+
 ItemFreeContainer::ItemFreeContainer(LayoutingHost *hostWidget, ItemContainer *parent)
     : ItemContainer(hostWidget, parent)
+    , d(new Private())
 {
 }
 
 ItemFreeContainer::ItemFreeContainer(LayoutingHost *hostWidget)
     : ItemContainer(hostWidget)
+    , d(new Private())
 {
 }
 
 ItemFreeContainer::~ItemFreeContainer()
 {
+    delete d;
 }
 
 void ItemFreeContainer::addDockWidget(Item *item, Point localPt)
@@ -44,6 +71,7 @@ void ItemFreeContainer::addDockWidget(Item *item, Point localPt)
     m_children.append(item);
     item->setParentContainer(this);
     item->setPos(localPt);
+    d->m_z[item] = ++d->m_lastZ;
 
     itemsChanged.emit();
 
@@ -55,6 +83,7 @@ void ItemFreeContainer::addDockWidget(Item *item, Point localPt)
 
 void ItemFreeContainer::clear()
 {
+    d->m_z.clear();
     deleteAll(m_children);
     m_children.clear();
 }
@@ -65,6 +94,7 @@ void ItemFreeContainer::removeItem(Item *item, bool hardRemove)
 
     if (hardRemove) {
         m_children.removeOne(item);
+        d->m_z.erase(item);
         delete item;
     } else {
         item->setIsVisible(false);
@@ -91,3 +121,26 @@ void ItemFreeContainer::onChildVisibleChanged(Item *, bool)
 {
     // Nothing needed to do in this layout type
 }
+
+void ItemFreeContainer::onChildGeometryChanged(Item *)
+{
+    // No separators to update in this layout type
+}
+
+void ItemFreeContainer::raise(Item *item)
+{
+    auto it = d->m_z.find(item);
+    if (it == d->m_z.end()) {
+        KDDW_ERROR("ItemFreeContainer::raise: Unknown item {}", ( void * )item);
+        return;
+    }
+
+    it->second = ++d->m_lastZ;
+}
+
+Item::List ItemFreeContainer::itemsInZOrder() const
+{
+    Item::List items = m_children;
+    d->sortByZ(items);
+    return items;
+}
@@ -43,6 +43,17 @@ public:
     void restore(Item *child) override;
     void onChildMinSizeChanged(Item *child) override;
     void onChildVisibleChanged(Item *child, bool visible) override;
+    void onChildGeometryChanged(Item *child) override;
+
+    /// @brief Brings @p item to the front. Items are added in front of the existing ones.
+    void raise(Item *item);
+
+    /// @brief Returns the children, the one at the back first
+    Item::List itemsInZOrder() const;
+
+private:
+    struct Private;
+    Private *const d;
 };
 
 }
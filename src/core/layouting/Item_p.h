@@ -17,7 +17,9 @@
 #include "kdbindings/signal.h"
 #include "nlohmann/json.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 #include <unordered_map>
 
 namespace KDDockWidgets {
@@ -28,6 +30,8 @@ class Group;
 class ItemContainer;
 class ItemBoxContainer;
 class Item;
+class LayoutTransaction;
+class JsonWriter;
 struct LengthOnSide;
 
 class LayoutingHost;
@@ -212,6 +216,10 @@ public:
     static Size hardcodedMaximumSize;
     static int separatorThickness;
 
+    /// Changes whenever any item's geometry, visibility or min/max size changes, or items
+    /// are added or removed. Lets callers cache results computed from the layout.
+    static uint64_t layoutGeneration();
+
     int x() const;
     int y() const;
     int width() const;
@@ -290,6 +298,8 @@ public:
     virtual void dumpLayout(int level = 0, bool printSeparators = true);
     virtual void setHost(KDDockWidgets::Core::LayoutingHost *);
     virtual void to_json(nlohmann::json &) const;
+    /// Streaming version of to_json(), writes the same JSON without building a DOM
+    virtual void serialize(JsonWriter &) const;
 
     virtual void fillFromJson(const nlohmann::json &,
                               const std::unordered_map<QString, LayoutingGuest *> &);
@@ -345,6 +355,7 @@ private:
     friend class ItemBoxContainer;
     friend class ItemFreeContainer;
     int m_refCount = 0;
+    bool m_hasPendingGuestGeometry = false; // See LayoutTransaction
     void updateObjectName();
     void onGuestDestroyed();
     bool m_isVisible = false;
@@ -360,6 +371,19 @@ private:
     KDBindings::ScopedConnection m_guestDestroyedConnection;
 };
 
+/// Calls @p visitor with @p arg. Visitors may return void, meaning they never stop the visit.
+/// See ItemContainer::visit_recursive()
+template<typename Visitor, typename T>
+bool invokeVisitor(Visitor &visitor, T *arg)
+{
+    if constexpr (std::is_void_v<std::invoke_result_t<Visitor &, T *>>) {
+        visitor(arg);
+        return true;
+    } else {
+        return visitor(arg);
+    }
+}
+
 /// @brief And Item which can contain other Items
 class DOCKS_EXPORT ItemContainer : public Item
 {
@@ -373,6 +397,7 @@ public:
     virtual void restore(Item *child) = 0;
     virtual void onChildMinSizeChanged(Item *child) = 0;
     virtual void onChildVisibleChanged(Item *child, bool visible) = 0;
+    virtual void onChildGeometryChanged(Item *child) = 0;
 
     int numVisibleChildren() const;
     int numChildren() const;
@@ -382,9 +407,47 @@ public:
     int indexOfChild(const Item *child) const;
     bool isEmpty() const;
     bool contains(const Item *item) const;
-    Item *itemForView(const LayoutingGuest *) const;
+    /// Returns the item below this container which hosts @p guest, nullptr if there's none.
+    /// Uses LayoutingGuest::layoutItem(), so it doesn't search the tree. Developer builds
+    /// cross-check the result against a full search.
+    Item *itemForView(const LayoutingGuest *guest) const;
     Item::List visibleChildren(bool includeBeingInserted = false) const;
+    /// Overload that fills @p result instead of returning a new list, so it doesn't allocate when
+    /// @p result has enough capacity. Returns @p result.
+    Item::List &visibleChildren(Item::List &result, bool includeBeingInserted = false) const;
     Item::List items_recursive() const;
+
+    /// What visit_recursive() visits
+    enum class VisitFilter {
+        Leaves, ///< All leaves, placeholders included. The same items as items_recursive()
+        VisibleLeaves, ///< Leaves showing their guest
+        Placeholders, ///< Hidden leaves, which remember where to restore their guest
+        Containers ///< Nested containers, not including this one
+    };
+
+    /// Calls @p visitor for the items below this container, depth-first and in layout order,
+    /// without building any list. Prefer it over items_recursive() in hot paths.
+    /// @p visitor takes an Item * and can return false to stop early, in which case this returns false.
+    template<typename Visitor>
+    bool visit_recursive(Visitor &&visitor, VisitFilter filter = VisitFilter::Leaves) const
+    {
+        for (Item *item : m_children) {
+            if (const ItemContainer *c = item->asContainer()) {
+                if (filter == VisitFilter::Containers && !invokeVisitor(visitor, item))
+                    return false;
+                if (!c->visit_recursive(visitor, filter))
+                    return false;
+            } else if (filter == VisitFilter::Leaves
+                       || (filter == VisitFilter::VisibleLeaves && item->isVisible())
+                       || (filter == VisitFilter::Placeholders && !item->isVisible())) {
+                if (!invokeVisitor(visitor, item))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
     bool contains_recursive(const Item *item) const;
     int visibleCount_recursive() const override;
     int count_recursive() const;
@@ -445,6 +508,7 @@ public:
     Rect suggestedDropRect(const Item *item, const Item *relativeTo,
                            KDDockWidgets::Location) const;
     void to_json(nlohmann::json &) const override;
+    void serialize(JsonWriter &) const override;
     void fillFromJson(const nlohmann::json &,
                       const std::unordered_map<QString, LayoutingGuest *> &) override;
     void clear() override;
@@ -471,6 +535,12 @@ public:
     int availableToSqueezeOnSide_recursive(const Item *child, Side, Qt::Orientation) const;
     int availableToGrowOnSide_recursive(const Item *child, Side, Qt::Orientation) const;
 
+    /// Returns the visible child at @p p, in our coordinates. Binary searches along our orientation.
+    Item *itemAt(Point p) const;
+    /// Returns the visible leaf at @p p, in our coordinates. Descends the tree and doesn't allocate,
+    /// once the layout was queried since its last change.
+    Item *itemAt_recursive(Point p) const;
+
 private:
     int indexOfVisibleChild(const Item *) const;
     void restore(Item *) override;
@@ -522,15 +592,16 @@ private:
 
     void onChildMinSizeChanged(Item *child) override;
     void onChildVisibleChanged(Item *child, bool visible) override;
+    void onChildGeometryChanged(Item *child) override;
     void updateSizeConstraints();
     SizingInfo::List sizes(bool ignoreBeingInserted = false) const;
-    Vector<int> calculateSqueezes(SizingInfo::List::const_iterator begin,
-                                  SizingInfo::List::const_iterator end, int needed,
-                                  NeighbourSqueezeStrategy, bool reversed = false) const;
+    SizingInfo::List &sizes(SizingInfo::List &result, bool ignoreBeingInserted = false) const;
+    void calculateSqueezes(SizingInfo::List::const_iterator begin,
+                           SizingInfo::List::const_iterator end, int needed,
+                           NeighbourSqueezeStrategy, Vector<int> &squeezes,
+                           bool reversed = false) const;
     Rect suggestedDropRectFallback(const Item *item, const Item *relativeTo,
                                    KDDockWidgets::Location) const;
-    Item *itemAt(Point p) const;
-    Item *itemAt_recursive(Point p) const;
     void setHost(KDDockWidgets::Core::LayoutingHost *) override;
     void setIsVisible(bool) override;
     bool isVisible(bool excludeBeingInserted = false) const override;
@@ -583,10 +654,32 @@ private:
 
     static bool s_inhibitSimplify;
     friend class Core::Item;
+    friend class Core::LayoutTransaction;
     struct Private;
     Private *const d;
 };
 
+/// @brief Defers updating separators and guest geometries until the scope ends
+///
+/// Building or restoring a layout inserts and removes many items, each of which would otherwise
+/// reposition all separators and guests. Within a transaction that's done only once, at the end.
+/// Transactions can be nested, only the outermost one applies the pending updates.
+/// The root item must outlive the transaction.
+class DOCKS_EXPORT LayoutTransaction
+{
+public:
+    /// Opens a transaction on @p item's root. No-op if there's no root, as in MDI.
+    explicit LayoutTransaction(Item *item);
+    ~LayoutTransaction();
+
+    /// Applies the pending updates now, instead of waiting for the destructor
+    void commit();
+
+private:
+    ItemBoxContainer *m_root = nullptr;
+    KDDW_DELETE_COPY_CTOR(LayoutTransaction)
+};
+
 /// QtQuick triggers a lot of resizes due to bindings being updated individually
 /// Only check sanity at the end of an operation, and not each time a binding gets evaluated
 /// Tests will fail with a warning if anything is wrong.
@@ -19,7 +19,9 @@ namespace KDDockWidgets {
 namespace Core {
 
 class LayoutingGuest;
+class LayoutingSeparator;
 class ItemContainer;
+class ItemBoxContainer;
 
 /// The interface graphical components need to implement in order to host a layout
 /// The layout engine doesn't know about any GUI, only about LayoutingHost.
@@ -45,9 +47,45 @@ public:
     void insertItemRelativeTo(Core::LayoutingGuest *guest, Core::LayoutingGuest *relativeTo, Location loc,
                               InitialOption initialOption = {});
 
+    /// Separators no longer needed by a container are kept hidden in a per-host pool, instead of
+    /// being freed. Docking and undocking then reuses them instead of creating new views.
+    /// Returns a pooled separator, now belonging to @p container, or nullptr if there's none.
+    LayoutingSeparator *takePooledSeparator(Qt::Orientation, Core::ItemBoxContainer *container);
+
+    /// Puts @p separator into the pool, see LayoutingSeparator::setPooled()
+    /// Frees it instead if the pool already has maxPooledSeparators(). If the cap was lowered
+    /// meanwhile, the pool is trimmed down to it too.
+    void releaseSeparator(LayoutingSeparator *separator);
+
+    /// Frees the pooled separators. Needs to be called before the host's view is deleted.
+    void clearSeparatorPool();
+
+    struct SeparatorPoolStats
+    {
+        int available = 0; ///< pooled right now
+        int peak = 0; ///< the most there were pooled at once
+        int reused = 0; ///< times a separator was taken from the pool instead of created
+        int discarded = 0; ///< separators freed because the pool was full
+    };
+    SeparatorPoolStats separatorPoolStats() const;
+
+    /// How many separators this host keeps pooled, at most. Core::Layout returns
+    /// Config::separatorPoolSize(). The default is for hosts outside of KDDW.
+    virtual int maxPooledSeparators() const;
+
     Core::ItemContainer *m_rootItem = nullptr;
 
 private:
+    Vector<LayoutingSeparator *> &pooledSeparators(Qt::Orientation);
+
+    /// Frees pooled separators until there's at most @p max
+    void trimSeparatorPool(int max);
+
+    // Separators don't change orientation, so one pool for each
+    Vector<LayoutingSeparator *> m_pooledHorizontalSeparators;
+    Vector<LayoutingSeparator *> m_pooledVerticalSeparators;
+    SeparatorPoolStats m_separatorPoolStats;
+
     LayoutingHost(const LayoutingHost &) = delete;
     LayoutingHost &operator=(const LayoutingHost &) = delete;
 };
@@ -34,6 +34,10 @@ public:
     virtual void setGeometry(Rect r) = 0;
     virtual void free();
 
+    /// Called when the separator is put into, or taken from, its host's separator pool.
+    /// Pooled separators should be hidden. See LayoutingHost::releaseSeparator().
+    virtual void setPooled(bool);
+
     int position() const;
     bool isVertical() const;
     ItemBoxContainer *parentContainer() const;
@@ -48,7 +52,8 @@ public:
 
     LayoutingHost *const m_host;
     const Qt::Orientation m_orientation;
-    Core::ItemBoxContainer *const m_parentContainer;
+    // Changes when recycled through the host's separator pool, nullptr while pooled
+    Core::ItemBoxContainer *m_parentContainer;
 
     static LayoutingSeparator *s_separatorBeingDragged;
 
@@ -21,9 +21,16 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
 #include <QFileInfo>
+#include <QProcess>
+#include <QThread>
 #include <QTimer>
 
+#include <algorithm>
+#include <functional>
+
 #include "nlohmann/json.hpp"
 
 using namespace KDDockWidgets;
@@ -31,6 +38,16 @@ using namespace KDDockWidgets::Core;
 
 static bool s_isVerbose = false;
 
+/// Outcome of linting one file in a worker process, see lintInParallel()
+struct LintResult
+{
+    QString filename;
+    bool ok = false;
+    bool crashed = false;
+    qint64 elapsedMs = 0;
+    QByteArray output;
+};
+
 struct LinterConfig
 {
     struct MainWindow
@@ -130,8 +147,171 @@ static bool lint(const QString &filename, LinterConfig config, bool isVerbose)
     return restorer.restoreFromFile(filename);
 }
 
+/// Lints each file in its own process, running up to @p jobs of them at the same time.
+/// Each worker gets a fresh DockRegistry, and a crash only fails the file that caused it.
+static std::vector<LintResult> lintInParallel(const LinterConfig &config, const QStringList &workerArgs,
+                                              const QString &configFile, int jobs)
+{
+    std::vector<LintResult> results(config.filesToLint.size());
+    std::vector<QElapsedTimer> timers(results.size());
+    std::size_t next = 0;
+    int running = 0;
+    QEventLoop loop;
+
+    std::function<void()> startNext;
+    auto onWorkerDone = [&](std::size_t index) {
+        results[index].elapsedMs = timers[index].elapsed();
+        running--;
+        startNext();
+        if (running == 0)
+            loop.quit();
+    };
+
+    startNext = [&] {
+        while (running < jobs && next < results.size()) {
+            const std::size_t index = next++;
+            results[index].filename = QString::fromStdString(config.filesToLint[index]);
+
+            QStringList args = workerArgs;
+            if (configFile.isEmpty()) {
+                args << results[index].filename;
+            } else {
+                // The worker reads the same config file, but only lints this entry
+                args << QStringLiteral("-c") << configFile << QStringLiteral("--file-index")
+                     << QString::number(index);
+            }
+
+            auto process = new QProcess(&loop);
+            process->setProcessChannelMode(QProcess::MergedChannels);
+
+            QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), &loop,
+                             [&, process, index](int exitCode, QProcess::ExitStatus status) {
+                                 LintResult &result = results[index];
+                                 result.crashed = status == QProcess::CrashExit;
+                                 result.ok = !result.crashed && exitCode == 0;
+                                 result.output = process->readAll();
+                                 process->deleteLater();
+                                 onWorkerDone(index);
+                             });
+
+            QObject::connect(process, &QProcess::errorOccurred, &loop, [&, process, index](QProcess::ProcessError error) {
+                // finished() isn't emitted in this case
+                if (error == QProcess::FailedToStart) {
+                    results[index].output = process->errorString().toUtf8();
+                    process->deleteLater();
+                    onWorkerDone(index);
+                }
+            });
+
+            running++;
+            timers[index].start();
+            process->start(QCoreApplication::applicationFilePath(), args);
+        }
+    };
+
+    startNext();
+    if (running > 0)
+        loop.exec();
+
+    return results;
+}
+
+/// Prints one line per file plus totals. Output of failed files is printed too.
+/// Also writes it as JSON to @p reportFilename, if not empty.
+static bool reportResults(const std::vector<LintResult> &results, qint64 elapsedMs, int jobs,
+                          const QString &reportFilename)
+{
+    int numFailed = 0;
+    nlohmann::json files = nlohmann::json::array();
+    for (const LintResult &result : results) {
+        const char *status = result.ok ? "ok" : (result.crashed ? "crashed" : "failed");
+        if (!result.ok)
+            numFailed++;
+
+        qInfo().noquote() << QString::fromLatin1(status).toUpper().leftJustified(8)
+                          << QString::number(result.elapsedMs).rightJustified(6) << "ms" << result.filename;
+        if (!result.ok && !result.output.isEmpty())
+            qInfo().noquote() << result.output.trimmed();
+
+        nlohmann::json file;
+        file["file"] = result.filename.toStdString();
+        file["status"] = status;
+        file["elapsedMs"] = result.elapsedMs;
+        file["output"] = result.output.toStdString();
+        files.push_back(file);
+    }
+
+    const int numPassed = int(results.size()) - numFailed;
+    qInfo().noquote() << QStringLiteral("%1 files, %2 passed, %3 failed, in %4 ms using %5 jobs")
+                             .arg(results.size())
+                             .arg(numPassed)
+                             .arg(numFailed)
+                             .arg(elapsedMs)
+                             .arg(jobs);
+
+    if (reportFilename.isEmpty())
+        return true;
+
+    nlohmann::json report;
+    report["files"] = files;
+    report["passed"] = numPassed;
+    report["failed"] = numFailed;
+    report["elapsedMs"] = elapsedMs;
+    report["jobs"] = jobs;
+
+    QFile f(reportFilename);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open" << reportFilename;
+        return false;
+    }
+
+    f.write(QByteArray::fromStdString(report.dump(4)));
+    return true;
+}
+
+/// Whether --headless was passed. Needs to be known before QApplication is created.
+static bool isHeadless(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/// Converts a saved layout between JSON and binary, see LayoutSaverFormat
+static bool convert(const QString &filename, const QString &outputFilename, LayoutSaverFormat format)
+{
+    QFile input(filename);
+    if (!input.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << filename;
+        return false;
+    }
+
+    const QByteArray converted = LayoutSaver::convertLayout(input.readAll(), format);
+    if (converted.isEmpty()) {
+        qWarning() << "Failed to parse" << filename;
+        return false;
+    }
+
+    QFile output(outputFilename);
+    if (!output.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open" << outputFilename;
+        return false;
+    }
+
+    output.write(converted);
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
+    if (isHeadless(argc, argv)) {
+        // No display needed. Inherited by the worker processes.
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication app(argc, argv);
 
     const auto frontends = Platform::frontendTypes();
@@ -147,12 +327,25 @@ int main(int argc, char *argv[])
     QCommandLineOption verboseOpt = { { "v", "verbose" }, "Verbose output" };
     QCommandLineOption strictOpt = { { "s", "strict" }, "Strict mode" };
     QCommandLineOption waitAtEndOpt = { { "w", "wait" }, "Waits instead of exiting. For debugging purposes." };
+    QCommandLineOption convertOpt = { { "convert" }, "Converts the layout to <format> (json or binary) instead of linting it. Requires --output.", "format" };
+    QCommandLineOption outputOpt = { { "o", "output" }, "Output file for --convert", "file" };
+    QCommandLineOption headlessOpt = { { "headless" }, "Doesn't need a display. Uses Qt's offscreen platform." };
+    QCommandLineOption jobsOpt = { { "j", "jobs" }, "Lints each file in its own process, <n> at a time. Defaults to the number of cores.", "n" };
+    QCommandLineOption reportOpt = { { "r", "report" }, "Writes a JSON report with the result and timing of each file. Implies --jobs.", "file" };
+    QCommandLineOption fileIndexOpt = { { "file-index" }, "Only lints the config file's entry at <index>. Used by --jobs workers.", "index" };
+    fileIndexOpt.setFlags(QCommandLineOption::HiddenFromHelp);
 
     parser.addOption(configFileOpt);
     parser.addOption(verboseOpt);
     parser.addOption(waitAtEndOpt);
     parser.addOption(strictOpt);
-    parser.addPositionalArgument("layout", "layout json file");
+    parser.addOption(convertOpt);
+    parser.addOption(outputOpt);
+    parser.addOption(headlessOpt);
+    parser.addOption(jobsOpt);
+    parser.addOption(reportOpt);
+    parser.addOption(fileIndexOpt);
+    parser.addPositionalArgument("layout", "layout file, json or binary");
     parser.addHelpOption();
 
     FrontendType frontendType = FrontendType::QtWidgets;
@@ -174,16 +367,81 @@ int main(int argc, char *argv[])
         frontendType = FrontendType::QtQuick;
 #endif
 
-    KDDockWidgets::initFrontend(frontendType);
-    KDDockWidgets::Config::self().setLayoutSaverStrictMode(parser.isSet(strictOpt));
+    if (parser.isSet(convertOpt)) {
+        const QString format = parser.value(convertOpt);
+        if (format != QLatin1String("json") && format != QLatin1String("binary")) {
+            qWarning() << "Unknown format" << format << "expected json or binary";
+            return 3;
+        }
+
+        if (parser.positionalArguments().size() != 1 || !parser.isSet(outputOpt)) {
+            qWarning() << "--convert expects one layout file and --output";
+            return 3;
+        }
+
+        const bool ok = convert(parser.positionalArguments().constFirst(), parser.value(outputOpt),
+                                format == QLatin1String("binary") ? LayoutSaverFormat::Binary : LayoutSaverFormat::Json);
+        return ok ? 0 : 2;
+    }
+
+    // Absolute, as requestedLinterConfig() changes the current directory to the config's
+    const QString configFile = parser.isSet(configFileOpt) ? QFileInfo(parser.value(configFileOpt)).absoluteFilePath() : QString();
 
     s_isVerbose = parser.isSet(verboseOpt);
-    const LinterConfig lc = requestedLinterConfig(parser, parser.isSet(configFileOpt) ? parser.value(configFileOpt) : QString());
+    LinterConfig lc = requestedLinterConfig(parser, configFile);
     if (lc.isEmpty()) {
         qWarning() << "Bailing out";
         return 3;
     }
 
+    if (parser.isSet(fileIndexOpt)) {
+        bool ok = false;
+        const int index = parser.value(fileIndexOpt).toInt(&ok);
+        if (!ok || index < 0 || index >= int(lc.filesToLint.size())) {
+            qWarning() << "Invalid --file-index" << parser.value(fileIndexOpt);
+            return 3;
+        }
+
+        lc.filesToLint = { lc.filesToLint[size_t(index)] };
+    }
+
+    if (parser.isSet(jobsOpt) || parser.isSet(reportOpt)) {
+        int jobs = QThread::idealThreadCount();
+        if (parser.isSet(jobsOpt)) {
+            bool ok = false;
+            jobs = parser.value(jobsOpt).toInt(&ok);
+            if (!ok || jobs < 1) {
+                qWarning() << "Invalid --jobs" << parser.value(jobsOpt);
+                return 3;
+            }
+        }
+
+        // Workers lint with the same settings
+        QStringList workerArgs;
+        for (const QCommandLineOption &opt : { headlessOpt, strictOpt, verboseOpt }) {
+            if (parser.isSet(opt))
+                workerArgs << QStringLiteral("--") + opt.names().constLast();
+        }
+#if defined(KDDW_FRONTEND_QTQUICK) && defined(KDDW_FRONTEND_QTWIDGETS)
+        if (frontendType == FrontendType::QtQuick)
+            workerArgs << QStringLiteral("--force-qtquick");
+#endif
+
+        QElapsedTimer timer;
+        timer.start();
+        const std::vector<LintResult> results = lintInParallel(lc, workerArgs, configFile, jobs);
+        const bool reported = reportResults(results, timer.elapsed(), jobs, parser.value(reportOpt));
+
+        const bool allPassed = std::all_of(results.cbegin(), results.cend(), [](const LintResult &result) {
+            return result.ok;
+        });
+
+        return allPassed && reported ? 0 : 2;
+    }
+
+    KDDockWidgets::initFrontend(frontendType);
+    KDDockWidgets::Config::self().setLayoutSaverStrictMode(parser.isSet(strictOpt));
+
     int exitCode = 0;
     for (const std::string &layout : lc.filesToLint) {
         if (!lint(QString::fromStdString(layout), lc, s_isVerbose))
@@ -17,6 +17,7 @@
 #include "core/Utils_p.h"
 #include "core/Logging_p.h"
 #include "core/DelayedCall_p.h"
+#include "core/Tracing_p.h"
 #include "qtcommon/View.h"
 
 #include <QWindow>
@@ -72,95 +73,44 @@ public:
 
     bool handleMoveEvent(QObject *o, QEvent *)
     {
-        if (q->d->m_globalEventFilters.empty())
+        if (!q->d->m_globalEventFilters.handles(EventFilterInterface::EventType_Move))
             return false;
 
         auto view = Platform_qt::instance()->qobjectAsView(o);
-        for (EventFilterInterface *filter : std::as_const(q->d->m_globalEventFilters)) {
-            if (filter->onMoveEvent(view.get()))
-                return true;
-        }
-
-        return false;
+        return q->d->m_globalEventFilters.deliverMoveEvent(view.get());
     }
 
     bool handleDnDEvent(QObject *o, QEvent *ev)
     {
-        if (q->d->m_globalEventFilters.empty())
+        if (!q->d->m_globalEventFilters.handles(EventFilterInterface::EventType_DnD))
             return false;
 
-        if (auto view = Platform_qt::instance()->qobjectAsView(o)) {
-            for (EventFilterInterface *filter : std::as_const(q->d->m_globalEventFilters)) {
-                if (filter->onDnDEvent(view.get(), ev))
-                    return true;
-            }
-        }
+        if (auto view = Platform_qt::instance()->qobjectAsView(o))
+            return q->d->m_globalEventFilters.deliverDnDEvent(view.get(), ev);
 
         return false;
     }
 
     bool handleExpose(QObject *o)
     {
-        if (q->d->m_globalEventFilters.empty())
+        if (!q->d->m_globalEventFilters.handles(EventFilterInterface::EventType_Expose))
             return false;
 
         auto window = Platform_qt::instance()->qobjectAsWindow(o);
         if (!window)
             return false;
 
-        for (EventFilterInterface *filter : std::as_const(q->d->m_globalEventFilters)) {
-            if (filter->onExposeEvent(window))
-                return true;
-        }
-
-        return false;
+        return q->d->m_globalEventFilters.deliverExposeEvent(window);
     }
 
     bool handleMouseEvent(QObject *watched, QMouseEvent *ev)
     {
-        if (q->d->m_globalEventFilters.empty())
+        // Mouse moves are the most frequent events, and usually nobody is interested
+        if (!q->d->m_globalEventFilters.handles(EventFilterList::eventTypeFor(ev->type())))
             return false;
 
         auto view = Platform_qt::instance()->qobjectAsView(watched);
-
-        // Make a copy, as there could be reentrancy and filters getting removed while event being
-        // processed
-        const auto filters = std::as_const(q->d->m_globalEventFilters);
-
-        for (EventFilterInterface *filter : filters) {
-
-            // Filter might have been deleted meanwhile
-            if (std::find(q->d->m_globalEventFilters.cbegin(), q->d->m_globalEventFilters.cend(),
-                          filter)
-                == q->d->m_globalEventFilters.cend())
-                continue;
-
-            if (filter->onMouseEvent(view.get(), ev))
-                return true;
-
-            switch (ev->type()) {
-            case QEvent::MouseButtonPress:
-                if (filter->onMouseButtonPress(view.get(), ev))
-                    return true;
-                break;
-            case QEvent::MouseButtonRelease:
-                if (filter->onMouseButtonRelease(view.get(), ev))
-                    return true;
-                break;
-            case QEvent::MouseMove:
-                if (filter->onMouseButtonMove(view.get(), ev))
-                    return true;
-                break;
-            case QEvent::MouseButtonDblClick:
-                if (filter->onMouseDoubleClick(view.get(), ev))
-                    return true;
-                break;
-            default:
-                break;
-            }
-        }
-
-        return false;
+        return q->d->m_globalEventFilters.deliverMouseEvent(view.get(), ev);
     }
 
     ~GlobalEventFilter() override;
@@ -322,7 +272,23 @@ Screen::Ptr Platform_qt::primaryScreen() const
 
 void Platform_qt::runDelayed(int ms, Core::DelayedCall *c)
 {
-    QTimer::singleShot(ms, qGuiApp, [c] { c->call(); delete c; });
+    QTimer::singleShot(ms, qGuiApp, [c] {
+        KDDW_TRACE_SCOPE("Platform::runDelayed");
+        c->call();
+        delete c;
+    });
+}
+
+void Platform_qt::runOnMainThread(Core::DelayedCall *c)
+{
+    // Queued, so it's thread-safe, unlike QTimer
+    QMetaObject::invokeMethod(
+        qGuiApp, [c] {
+            KDDW_TRACE_SCOPE("Platform::runOnMainThread");
+            c->call();
+            delete c;
+        },
+        Qt::QueuedConnection);
 }
 
 QByteArray Platform_qt::readFile(const QString &fileName, bool &ok) const
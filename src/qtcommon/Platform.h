@@ -67,6 +67,7 @@ public:
     std::shared_ptr<Core::Screen> primaryScreen() const override;
 
     void runDelayed(int ms, Core::DelayedCall *) override;
+    void runOnMainThread(Core::DelayedCall *) override;
 
     QByteArray readFile(const QString &fileName, bool &ok) const override;
 
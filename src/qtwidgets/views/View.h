@@ -176,6 +176,11 @@ public:
         Base::update();
     }
 
+    void updateRect(QRect rect) override
+    {
+        Base::update(rect);
+    }
+
     static void setParentFor(QWidget *widget, Core::View *parent)
     {
         if (!parent) {
@@ -0,0 +1,141 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+// Measures the latency of floating a dock widget and docking it back, with and without
+// recycling groups through Config::setGroupPoolSize(), and with pre-created floating windows
+// from Config::setFloatingWindowPoolSize().
+//
+// Only the setFloating() calls are timed. The event loop runs between them, so emptied groups
+// and floating windows get deleted, or recycled, outside of the measurement.
+//
+// Unlike bench_multisplitter this one needs a platform, as real views are created.
+
+#include "Config.h"
+#include "simple_test_framework.h"
+#include "utils.h"
+#include "core/DockRegistry.h"
+#include "core/DockWidget.h"
+#include "core/GroupPool_p.h"
+#include "core/FloatingWindowPool_p.h"
+#include "core/MainWindow.h"
+#include "core/Platform.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+using namespace KDDockWidgets::Tests;
+
+namespace {
+
+constexpr int s_numDocks = 4;
+constexpr int s_iterations = 50;
+
+struct Result
+{
+    double floatUs = 0;
+    double dockUs = 0;
+};
+
+KDDW_QCORO_TASK runRoundTrips(int groupPoolSize, int floatingWindowPoolSize, Result &result)
+{
+    EnsureTopLevelsDeleted e;
+    Config::self().setGroupPoolSize(groupPoolSize);
+    Config::self().setFloatingWindowPoolSize(floatingWindowPoolSize);
+
+    auto m = createMainWindow(Size(1000, 800), MainWindowOption_None, "bench_dockundock");
+    DockWidget *docks[s_numDocks];
+    for (int i = 0; i < s_numDocks; ++i) {
+        docks[i] = createDockWidget(QString("dock") + QString::number(i), Platform::instance()->tests_createView({ true }));
+        m->addDockWidget(docks[i], i % 2 == 0 ? Location_OnLeft : Location_OnBottom);
+    }
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(50);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::duration floatTime {};
+    Clock::duration dockTime {};
+
+    for (int i = 0; i < s_iterations; ++i) {
+        DockWidget *dock = docks[i % s_numDocks];
+
+        auto start = Clock::now();
+        dock->setFloating(true);
+        floatTime += Clock::now() - start;
+        KDDW_CO_AWAIT Platform::instance()->tests_wait(1);
+
+        start = Clock::now();
+        dock->setFloating(false);
+        dockTime += Clock::now() - start;
+        KDDW_CO_AWAIT Platform::instance()->tests_wait(1);
+    }
+
+    CHECK(m->layout()->checkSanity());
+
+    using Micro = std::chrono::duration<double, std::micro>;
+    result.floatUs = Micro(floatTime).count() / s_iterations;
+    result.dockUs = Micro(dockTime).count() / s_iterations;
+
+    Config::self().setGroupPoolSize(0);
+    Config::self().setFloatingWindowPoolSize(0);
+    DockRegistry::self()->groupPool()->clear();
+    DockRegistry::self()->floatingWindowPool()->clear();
+
+    KDDW_TEST_RETURN(true);
+}
+
+}
+
+KDDW_QCORO_TASK bench_dockundock()
+{
+    Result unpooled;
+    CHECK(KDDW_CO_AWAIT runRoundTrips(0, 0, unpooled));
+
+    const GroupPool::Stats before = DockRegistry::self()->groupPool()->stats();
+    Result pooled;
+    CHECK(KDDW_CO_AWAIT runRoundTrips(s_numDocks, 0, pooled));
+
+    // Each round trip creates two groups, all of them should have been recycled
+    const GroupPool::Stats after = DockRegistry::self()->groupPool()->stats();
+    const int reused = after.reused - before.reused;
+    CHECK(reused >= 2 * s_iterations);
+
+    // Floating windows are created while idle, so each tear-off should find one ready
+    const FloatingWindowPool::Stats windowsBefore = DockRegistry::self()->floatingWindowPool()->stats();
+    Result warm;
+    CHECK(KDDW_CO_AWAIT runRoundTrips(s_numDocks, 1, warm));
+    const FloatingWindowPool::Stats windowsAfter = DockRegistry::self()->floatingWindowPool()->stats();
+    const int windowsTaken = windowsAfter.taken - windowsBefore.taken;
+    CHECK(windowsTaken >= s_iterations);
+
+    std::cout << "\n"
+              << std::left << std::setw(12) << "mode" << std::right << std::setw(14) << "float us"
+              << std::setw(14) << "dock us"
+              << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(12) << "new" << std::right << std::setw(14) << unpooled.floatUs
+              << std::setw(14) << unpooled.dockUs << "\n";
+    std::cout << std::left << std::setw(12) << "pooled" << std::right << std::setw(14) << pooled.floatUs
+              << std::setw(14) << pooled.dockUs << "\n";
+    std::cout << std::left << std::setw(12) << "warm" << std::right << std::setw(14) << warm.floatUs
+              << std::setw(14) << warm.dockUs << "\n";
+    std::cout << "groups reused: " << reused << ", peak pooled: " << after.peak
+              << ", floating windows taken: " << windowsTaken << "\n\n";
+
+    KDDW_TEST_RETURN(true);
+}
+
+static const auto s_tests = std::vector<KDDWTest> {
+    TEST(bench_dockundock),
+};
+
+#include "tests_main.h"
@@ -0,0 +1,214 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+// A headless micro-benchmark for event filter dispatch.
+//
+// Installs a mix of filters resembling a real application's: one that only wants expose and
+// press events (like DockRegistry), one for drag and drop (like DragController) and
+// <filters> mouse-only ones (like WidgetResizeHandler). Then delivers a stream of synthetic
+// mouse moves and window moves, the hottest events, to them.
+//
+// The "all" mode has every filter declare EventType_All, which is how filters were offered
+// events before EventFilterInterface::eventTypes() existed. The "masked" mode uses the
+// filters' real masks.
+//
+// Usage: bench_eventfilters [--filters <n>] [--events <n>]
+
+#include "core/EventFilterList_p.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef KDDW_FRONTEND_QT
+#include <QCoreApplication>
+#endif
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+namespace {
+
+/// Number of virtual handlers that were called
+uint64_t s_handlerCalls = 0;
+
+class BenchFilter : public EventFilterInterface
+{
+public:
+    explicit BenchFilter(EventTypes types)
+        : m_types(types)
+    {
+    }
+
+    EventTypes eventTypes() const override
+    {
+        return m_types;
+    }
+
+    bool onExposeEvent(std::shared_ptr<Window>) override
+    {
+        s_handlerCalls++;
+        return false;
+    }
+
+    bool onDnDEvent(View *, Event *) override
+    {
+        s_handlerCalls++;
+        return false;
+    }
+
+    bool onMoveEvent(View *) override
+    {
+        s_handlerCalls++;
+        return false;
+    }
+
+    bool onMouseEvent(View *, MouseEvent *) override
+    {
+        s_handlerCalls++;
+        return false;
+    }
+
+    bool onMouseButtonMove(View *, MouseEvent *) override
+    {
+        s_handlerCalls++;
+        return false;
+    }
+
+private:
+    const EventTypes m_types;
+};
+
+struct Options
+{
+    int filters = 8;
+    int events = 100000;
+};
+
+struct Result
+{
+    const char *name;
+    double nsPerEvent = 0;
+    double handlerCallsPerEvent = 0;
+};
+
+Result run(const char *name, bool masked, const Options &options)
+{
+    std::vector<std::unique_ptr<BenchFilter>> filters;
+    auto addFilter = [&filters, masked](EventFilterInterface::EventTypes types) {
+        if (!masked)
+            types = EventFilterInterface::EventType_All;
+        filters.push_back(std::make_unique<BenchFilter>(types));
+    };
+
+    EventFilterInterface::EventTypes registryTypes = EventFilterInterface::EventType_Expose;
+    registryTypes |= EventFilterInterface::EventType_MouseButtonPress;
+    addFilter(registryTypes);
+
+    EventFilterInterface::EventTypes dragTypes = EventFilterInterface::EventType_Mouse;
+    dragTypes |= EventFilterInterface::EventType_DnD;
+    dragTypes |= EventFilterInterface::EventType_Move;
+    addFilter(dragTypes);
+
+    for (int i = 0; i < options.filters; ++i)
+        addFilter(EventFilterInterface::EventType_Mouse);
+
+    EventFilterList list;
+    for (const auto &filter : filters)
+        list.add(filter.get());
+
+    MouseEvent mouseMove(Event::MouseMove, Point(10, 10), Point(10, 10), Point(10, 10), Qt::NoButton,
+                         Qt::NoButton, Qt::NoModifier);
+
+    s_handlerCalls = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.events; ++i) {
+        // A window being dragged gets a move event for each mouse move
+        list.deliverMouseEvent(nullptr, &mouseMove);
+        list.deliverMoveEvent(nullptr);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double numEvents = 2.0 * options.events;
+    Result result { name };
+    result.nsPerEvent = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / numEvents;
+    result.handlerCallsPerEvent = double(s_handlerCalls) / numEvents;
+    return result;
+}
+
+void usage()
+{
+    std::cerr << "Usage: bench_eventfilters [--filters <n>] [--events <n>]\n";
+}
+
+bool parseArguments(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 == argc)
+            return false;
+
+        const int number = std::atoi(argv[++i]);
+        if (number <= 0)
+            return false;
+
+        if (arg == "--filters") {
+            options.filters = number;
+        } else if (arg == "--events") {
+            options.events = number;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+#ifdef KDDW_FRONTEND_QT
+    QCoreApplication app(argc, argv);
+#endif
+
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    const std::vector<Result> results = { run("all", false, options), run("masked", true, options) };
+
+    std::cout << "filters=" << options.filters + 2 << " events=" << 2 * options.events << "\n\n";
+    std::cout << std::left << std::setw(16) << "mode" << std::right << std::setw(14) << "ns/event"
+              << std::setw(16) << "handlers/event"
+              << "\n";
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Result &result : results) {
+        std::cout << std::left << std::setw(16) << result.name << std::right << std::setw(14)
+                  << result.nsPerEvent << std::setw(16) << result.handlerCallsPerEvent << "\n";
+    }
+
+    // Masks are only there to save work
+    if (results[1].handlerCallsPerEvent > results[0].handlerCallsPerEvent) {
+        std::cerr << "Masked dispatch called more handlers than unmasked\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,727 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+// A headless benchmark for the layouting engine.
+//
+// It implements LayoutingHost, LayoutingGuest and LayoutingSeparator without any views, so it
+// doesn't need a Platform nor a windowing system, only the engine is measured.
+//
+// A synthetic layout is built by splitting each leaf into <width> leaves, alternating between
+// horizontal and vertical, <depth> times. That's width^depth leaves.
+//
+// Usage: bench_multisplitter [--depth <n>] [--width <n>] [--iterations <n>] [--json <file>|-]
+//                            [--trace <file>]
+//
+// --trace writes the spans recorded while benchmarking in the Chrome trace event format.
+// Needs a -DKDDockWidgets_TRACING=ON build.
+
+#include "core/layouting/Item_p.h"
+#include "core/layouting/LayoutingHost_p.h"
+#include "core/layouting/LayoutingGuest_p.h"
+#include "core/layouting/LayoutingSeparator_p.h"
+#include "core/JsonWriter_p.h"
+#include "core/Tracing_p.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef KDDW_FRONTEND_QT
+#include <QCoreApplication>
+#endif
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+namespace {
+
+struct AllocationStats
+{
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+AllocationStats s_allocations;
+
+/// Number of geometries pushed to guests and separators. In a real application each one
+/// would be a widget resize or move.
+uint64_t s_geometryUpdates = 0;
+
+}
+
+#if defined(__GLIBC__)
+// Interpose malloc, so we also count allocations which don't go through operator new,
+// for example QVector's.
+extern "C" {
+void *__libc_malloc(size_t);
+void *__libc_calloc(size_t, size_t);
+void *__libc_realloc(void *, size_t);
+
+void *malloc(size_t size) noexcept
+{
+    s_allocations.count++;
+    s_allocations.bytes += size;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size) noexcept
+{
+    s_allocations.count++;
+    s_allocations.bytes += num * size;
+    return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+    s_allocations.count++;
+    s_allocations.bytes += size;
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+void *operator new(std::size_t size)
+{
+    s_allocations.count++;
+    s_allocations.bytes += size;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+namespace {
+
+class BenchSeparator : public LayoutingSeparator
+{
+public:
+    BenchSeparator(LayoutingHost *host, Qt::Orientation orientation, ItemBoxContainer *container)
+        : LayoutingSeparator(host, orientation, container)
+    {
+    }
+
+    Rect geometry() const override
+    {
+        return m_geometry;
+    }
+
+    void setGeometry(Rect r) override
+    {
+        s_geometryUpdates++;
+        m_geometry = r;
+    }
+
+private:
+    Rect m_geometry;
+};
+
+class BenchGuest : public LayoutingGuest
+{
+public:
+    explicit BenchGuest(const QString &id)
+        : m_id(id)
+    {
+    }
+
+    ~BenchGuest() override
+    {
+        beingDestroyed.emit();
+    }
+
+    Size minSize() const override
+    {
+        return Item::hardcodedMinimumSize;
+    }
+
+    Size maxSizeHint() const override
+    {
+        return Item::hardcodedMaximumSize;
+    }
+
+    void setGeometry(Rect r) override
+    {
+        s_geometryUpdates++;
+        m_geometry = r;
+    }
+
+    void setVisible(bool) override
+    {
+    }
+
+    Rect geometry() const override
+    {
+        return m_geometry;
+    }
+
+    void setHost(LayoutingHost *host) override
+    {
+        m_host = host;
+    }
+
+    LayoutingHost *host() const override
+    {
+        return m_host;
+    }
+
+    QString id() const override
+    {
+        return m_id;
+    }
+
+private:
+    const QString m_id;
+    Rect m_geometry;
+    LayoutingHost *m_host = nullptr;
+};
+
+class BenchHost : public LayoutingHost
+{
+public:
+    BenchHost()
+    {
+        m_rootItem = new ItemBoxContainer(this);
+        m_rootItem->setSize({ 1000, 1000 });
+    }
+
+    ~BenchHost() override
+    {
+        // Items reference the guests, delete them first
+        delete m_rootItem;
+        m_rootItem = nullptr;
+    }
+
+    bool supportsHonouringLayoutMinSize() const override
+    {
+        return true;
+    }
+
+    ItemBoxContainer *root() const
+    {
+        return static_cast<ItemBoxContainer *>(m_rootItem);
+    }
+
+    /// Creates @p count guests. Their ids are stable, so a layout can be restored into another host.
+    void createGuests(int count)
+    {
+        m_guests.reserve(count);
+        for (int i = 0; i < count; ++i)
+            m_guests.push_back(std::make_unique<BenchGuest>(QString::number(i)));
+    }
+
+    /// Creates one item per guest, without inserting them into the layout
+    std::vector<Item *> createItems() const
+    {
+        std::vector<Item *> items;
+        items.reserve(m_guests.size());
+        for (const auto &guest : m_guests) {
+            auto item = new Item(const_cast<BenchHost *>(this));
+            item->setGuest(guest.get());
+            items.push_back(item);
+        }
+
+        return items;
+    }
+
+    std::unordered_map<QString, LayoutingGuest *> guestsById() const
+    {
+        std::unordered_map<QString, LayoutingGuest *> result;
+        for (const auto &guest : m_guests)
+            result[guest->id()] = guest.get();
+
+        return result;
+    }
+
+private:
+    std::vector<std::unique_ptr<BenchGuest>> m_guests;
+};
+
+struct Options
+{
+    int depth = 3;
+    int width = 5;
+    int iterations = 10;
+    std::string jsonFile;
+    std::string traceFile;
+};
+
+struct Result
+{
+    std::string name;
+    uint64_t ops = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t geometryUpdates = 0;
+
+    double perOp(uint64_t value) const
+    {
+        return ops == 0 ? 0 : double(value) / double(ops);
+    }
+};
+
+/// Runs @p func and adds its duration and allocations to @p result
+template<typename Func>
+void measure(Result &result, uint64_t ops, Func &&func)
+{
+    const AllocationStats before = s_allocations;
+    const uint64_t geometryUpdatesBefore = s_geometryUpdates;
+    const auto start = std::chrono::steady_clock::now();
+
+    func();
+
+    const auto end = std::chrono::steady_clock::now();
+    result.ops += ops;
+    result.nanoseconds += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    result.allocations += s_allocations.count - before.count;
+    result.allocatedBytes += s_allocations.bytes - before.bytes;
+    result.geometryUpdates += s_geometryUpdates - geometryUpdatesBefore;
+}
+
+int leafCount(const Options &options)
+{
+    int count = 1;
+    for (int i = 0; i < options.depth; ++i)
+        count *= options.width;
+    return count;
+}
+
+/// Splits @p leaf into options.width siblings, then recurses into each of them
+void split(Item *leaf, int level, const Options &options, std::vector<Item *> &pool, size_t &next)
+{
+    if (level == options.depth)
+        return;
+
+    const Location location = level % 2 == 0 ? Location_OnRight : Location_OnBottom;
+
+    std::vector<Item *> siblings = { leaf };
+    for (int i = 1; i < options.width; ++i) {
+        Item *item = pool[next++];
+        ItemBoxContainer::insertItemRelativeTo(item, siblings.back(), location);
+        siblings.push_back(item);
+    }
+
+    for (Item *sibling : siblings)
+        split(sibling, level + 1, options, pool, next);
+}
+
+void buildLayout(BenchHost &host, std::vector<Item *> &items, const Options &options)
+{
+    size_t next = 0;
+    Item *first = items[next++];
+    host.root()->insertItem(first, Location_OnLeft);
+    split(first, 0, options, items, next);
+}
+
+bool checkSanity(BenchHost &host, const char *when)
+{
+    if (!host.root()->checkSanity()) {
+        std::cerr << "Layout isn't sane " << when << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+void usage()
+{
+    std::cerr << "Usage: bench_multisplitter [--depth <n>] [--width <n>] [--iterations <n>] [--json <file>|-] [--trace <file>]\n";
+}
+
+bool parseArguments(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 == argc)
+            return false;
+
+        const std::string value = argv[++i];
+        if (arg == "--json") {
+            options.jsonFile = value;
+            continue;
+        }
+
+        if (arg == "--trace") {
+#ifdef KDDW_TRACING
+            options.traceFile = value;
+            continue;
+#else
+            std::cerr << "--trace needs a build with -DKDDockWidgets_TRACING=ON\n";
+            return false;
+#endif
+        }
+
+        const int number = std::atoi(value.c_str());
+        if (number <= 0)
+            return false;
+
+        if (arg == "--depth") {
+            options.depth = number;
+        } else if (arg == "--width") {
+            options.width = number;
+        } else if (arg == "--iterations") {
+            options.iterations = number;
+        } else {
+            return false;
+        }
+    }
+
+    // The root always has at least 2 children, otherwise there's nothing to lay out
+    return options.width > 1;
+}
+
+/// Size of the serialized layout, in bytes
+struct SerializedSizes
+{
+    std::size_t json = 0;
+    std::size_t binary = 0;
+};
+
+void printResults(const Options &options, const std::vector<Result> &results, SerializedSizes sizes)
+{
+    std::cout << "depth=" << options.depth << " width=" << options.width
+              << " leaves=" << leafCount(options) << " iterations=" << options.iterations << "\n\n";
+
+    std::cout << std::left << std::setw(16) << "operation" << std::right << std::setw(10) << "ops"
+              << std::setw(14) << "ns/op" << std::setw(14) << "allocs/op" << std::setw(14)
+              << "bytes/op" << std::setw(14) << "updates/op"
+              << "\n";
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Result &result : results) {
+        std::cout << std::left << std::setw(16) << result.name << std::right << std::setw(10)
+                  << result.ops << std::setw(14) << result.perOp(result.nanoseconds)
+                  << std::setw(14) << result.perOp(result.allocations) << std::setw(14)
+                  << result.perOp(result.allocatedBytes) << std::setw(14)
+                  << result.perOp(result.geometryUpdates) << "\n";
+    }
+
+    std::cout << "\nserialized size: json=" << sizes.json << " bytes, binary=" << sizes.binary
+              << " bytes\n";
+}
+
+bool writeJson(const Options &options, const std::vector<Result> &results, SerializedSizes sizes)
+{
+    nlohmann::json json;
+    json["benchmark"] = "bench_multisplitter";
+    json["parameters"] = { { "depth", options.depth },
+                           { "width", options.width },
+                           { "leaves", leafCount(options) },
+                           { "iterations", options.iterations } };
+
+    auto jsonResults = nlohmann::json::array();
+    for (const Result &result : results) {
+        jsonResults.push_back({ { "name", result.name },
+                                { "ops", result.ops },
+                                { "ns_per_op", result.perOp(result.nanoseconds) },
+                                { "allocs_per_op", result.perOp(result.allocations) },
+                                { "bytes_per_op", result.perOp(result.allocatedBytes) },
+                                { "geometry_updates_per_op", result.perOp(result.geometryUpdates) } });
+    }
+    json["results"] = jsonResults;
+    json["serialized_bytes"] = { { "json", sizes.json }, { "binary", sizes.binary } };
+
+    if (options.jsonFile == "-") {
+        std::cout << json.dump(4) << "\n";
+        return true;
+    }
+
+    std::ofstream file(options.jsonFile);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << options.jsonFile << "\n";
+        return false;
+    }
+
+    file << json.dump(4) << "\n";
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+#ifdef KDDW_FRONTEND_QT
+    QCoreApplication app(argc, argv);
+#endif
+
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    Item::setCreateSeparatorFunc([](LayoutingHost *host, Qt::Orientation orientation,
+                                    ItemBoxContainer *container) -> LayoutingSeparator * {
+        return new BenchSeparator(host, orientation, container);
+    });
+
+    // Developer-mode sanity checks are expensive and would dominate the measurements.
+    // We call checkSanity() explicitly instead, outside of the measured sections.
+    Item::s_silenceSanityChecks = true;
+
+    const int numLeaves = leafCount(options);
+
+#ifdef KDDW_TRACING
+    if (!options.traceFile.empty())
+        Tracer::setEnabled(true);
+#endif
+
+    Result insert { "insert" };
+    Result insertBatched { "insert-batched" };
+    Result resize { "resize" };
+    Result separatorDrag { "separator-drag" };
+    Result hitTest { "hit-test" };
+    Result guestLookup { "guest-lookup" };
+    Result toJson { "to-json" };
+    Result serialize { "serialize" };
+    Result serializeBinary { "serialize-cbor" };
+    Result parseJson { "parse-json" };
+    Result parseBinary { "parse-cbor" };
+    Result fromJson { "from-json" };
+    SerializedSizes sizes;
+    Result remove { "remove" };
+    Result reinsert { "reinsert" };
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        BenchHost host;
+        host.createGuests(numLeaves);
+        std::vector<Item *> items = host.createItems();
+
+        measure(insert, uint64_t(numLeaves), [&] {
+            buildLayout(host, items, options);
+        });
+
+        // Only check once, as checkSanity() is expensive
+        if (iteration == 0 && !checkSanity(host, "after insertion"))
+            return 1;
+
+        // Grow and shrink the whole layout, without going below its minimum size
+        ItemBoxContainer *root = host.root();
+        const Size baseSize = root->minSize() + Size(200, 200);
+        root->setSize_recursive(baseSize);
+        const int resizeSteps = 20;
+        measure(resize, resizeSteps, [&] {
+            for (int i = 1; i <= resizeSteps; ++i) {
+                const int delta = (i % 2 == 0 ? -1 : 1) * 10 * (i / 2);
+                root->setSize_recursive(baseSize + Size(delta, delta));
+            }
+        });
+
+        // Drag every separator back and forth, like a user would with the mouse
+        const auto separators = root->separators_recursive();
+        const int dragSteps = 10;
+        const uint64_t dragAllocationsBefore = separatorDrag.allocations;
+        measure(separatorDrag, uint64_t(separators.size()) * dragSteps * 2, [&] {
+            for (LayoutingSeparator *separator : separators) {
+                // Separator geometry is already in root coordinates
+                const Point start = separator->geometry().topLeft();
+                auto moveTo = [separator, start](int delta) {
+                    separator->onMouseMove(separator->isVertical() ? start + Point(0, delta)
+                                                                   : start + Point(delta, 0));
+                };
+
+                separator->onMousePress();
+                for (int i = 1; i <= dragSteps; ++i)
+                    moveTo(i);
+                for (int i = dragSteps - 1; i >= 0; --i)
+                    moveTo(i);
+                separator->onMouseRelease();
+            }
+        });
+
+        if (iteration == 0 && !checkSanity(host, "after dragging separators"))
+            return 1;
+
+        // The layout's scratch lists were warmed up by the first iteration, dragging must not
+        // allocate anymore
+        if (iteration > 0 && separatorDrag.allocations != dragAllocationsBefore) {
+            std::cerr << "Dragging separators allocated "
+                      << (separatorDrag.allocations - dragAllocationsBefore) << " times\n";
+            return 1;
+        }
+
+        // Find the leaf under a point, like DropArea::groupContainingPos() does for every mouse
+        // move while dragging a window. Hits the center of every leaf.
+        std::vector<Point> centers;
+        centers.reserve(items.size());
+        for (Item *item : items)
+            centers.push_back(item->mapToRoot(item->rect()).center());
+
+        // Warms up each container's cached child positions
+        for (Point center : centers)
+            root->itemAt_recursive(center);
+
+        const int hitTestPasses = 10;
+        int misses = 0;
+        const uint64_t hitTestAllocationsBefore = hitTest.allocations;
+        measure(hitTest, uint64_t(centers.size()) * hitTestPasses, [&] {
+            for (int pass = 0; pass < hitTestPasses; ++pass) {
+                for (std::size_t i = 0; i < centers.size(); ++i) {
+                    if (root->itemAt_recursive(centers[i]) != items[i])
+                        ++misses;
+                }
+            }
+        });
+
+        if (misses > 0) {
+            std::cerr << "Hit testing missed " << misses << " leaves\n";
+            return 1;
+        }
+
+        if (hitTest.allocations != hitTestAllocationsBefore) {
+            std::cerr << "Hit testing allocated " << (hitTest.allocations - hitTestAllocationsBefore)
+                      << " times\n";
+            return 1;
+        }
+
+        // Find each guest's item, like Layout::itemForFrame() does for MDI moves and resizes.
+        // Developer builds also cross-check against a full search, so only release timings matter.
+        const int lookupPasses = 10;
+        int wrongItems = 0;
+        measure(guestLookup, uint64_t(items.size()) * lookupPasses, [&] {
+            for (int pass = 0; pass < lookupPasses; ++pass) {
+                for (Item *item : items) {
+                    if (root->itemForView(item->guest()) != item)
+                        ++wrongItems;
+                }
+            }
+        });
+
+        if (wrongItems > 0) {
+            std::cerr << "Looking up guests returned " << wrongItems << " wrong items\n";
+            return 1;
+        }
+
+        // Save, then restore into a new host
+        nlohmann::json json;
+        measure(toJson, 1, [&] {
+            root->to_json(json);
+        });
+
+        // Same, but streamed without a DOM. Must match nlohmann's output byte by byte.
+        std::string serialized;
+        measure(serialize, 1, [&] {
+            JsonWriter writer([&serialized](const char *data, std::size_t size) {
+                serialized.append(data, size);
+            });
+            root->serialize(writer);
+        });
+
+        if (iteration == 0 && serialized != json.dump(4)) {
+            std::cerr << "Streamed JSON differs from nlohmann::json::dump()\n";
+            return 1;
+        }
+
+        // The binary encoding LayoutSaverFormat::Binary uses
+        std::string serializedBinary;
+        measure(serializeBinary, 1, [&] {
+            auto sink = [&serializedBinary](const char *data, std::size_t size) {
+                serializedBinary.append(data, size);
+            };
+            JsonWriter writer(sink, JsonWriter::Encoding::Cbor);
+            root->serialize(writer);
+        });
+
+        // Parsing is what dominates restoring a layout, fillFromJson() only walks the DOM
+        nlohmann::json parsed;
+        measure(parseJson, 1, [&] {
+            parsed = nlohmann::json::parse(serialized);
+        });
+
+        nlohmann::json parsedBinary;
+        measure(parseBinary, 1, [&] {
+            parsedBinary = nlohmann::json::from_cbor(serializedBinary);
+        });
+
+        if (iteration == 0 && (parsed != json || parsedBinary != json)) {
+            std::cerr << "Parsed layout differs from the serialized one\n";
+            return 1;
+        }
+
+        sizes = { serialized.size(), serializedBinary.size() };
+
+        {
+            BenchHost restoredHost;
+            restoredHost.createGuests(numLeaves);
+            const auto guests = restoredHost.guestsById();
+            measure(fromJson, 1, [&] {
+                restoredHost.root()->fillFromJson(json, guests);
+            });
+
+            if (iteration == 0 && !checkSanity(restoredHost, "after restoring"))
+                return 1;
+        }
+
+        measure(remove, uint64_t(numLeaves), [&] {
+            for (Item *item : items)
+                item->parentContainer()->removeItem(item);
+        });
+
+        // Build it again on the same host, its separators are recycled from the host's pool
+        std::vector<Item *> reinsertedItems = host.createItems();
+        measure(reinsert, uint64_t(numLeaves), [&] {
+            buildLayout(host, reinsertedItems, options);
+        });
+
+        if (iteration == 0) {
+            if (!checkSanity(host, "after reinsertion"))
+                return 1;
+
+            if (host.separatorPoolStats().reused == 0) {
+                std::cerr << "Separators weren't recycled\n";
+                return 1;
+            }
+        }
+
+        // Same as "insert", but within a LayoutTransaction
+        BenchHost batchedHost;
+        batchedHost.createGuests(numLeaves);
+        std::vector<Item *> batchedItems = batchedHost.createItems();
+        measure(insertBatched, uint64_t(numLeaves), [&] {
+            LayoutTransaction transaction(batchedHost.root());
+            buildLayout(batchedHost, batchedItems, options);
+        });
+
+        if (iteration == 0 && !checkSanity(batchedHost, "after batched insertion"))
+            return 1;
+    }
+
+    const std::vector<Result> results = { insert, insertBatched, resize, separatorDrag, hitTest,
+                                          guestLookup, toJson, serialize, serializeBinary, parseJson,
+                                          parseBinary, fromJson, remove, reinsert };
+    printResults(options, results, sizes);
+
+    if (!options.jsonFile.empty() && !writeJson(options, results, sizes))
+        return 1;
+
+#ifdef KDDW_TRACING
+    if (!options.traceFile.empty() && !Tracer::writeChromeTrace(QString::fromStdString(options.traceFile)))
+        return 1;
+#endif
+
+    return 0;
+}
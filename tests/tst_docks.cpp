@@ -39,6 +39,8 @@
 #include "core/Stack.h"
 #include "core/SideBar.h"
 #include "core/Platform.h"
+#include "core/GroupPool_p.h"
+#include "core/FloatingWindowPool_p.h"
 
 #include <cstdlib>
 
@@ -113,6 +115,38 @@ KDDW_QCORO_TASK tst_doesntHaveNativeTitleBar()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_dockByName()
+{
+    // Tests that DockRegistry's name index stays in sync with registration
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(500, 500), MainWindowOption_None, "mainWindowByName");
+    auto dr = DockRegistry::self();
+    CHECK_EQ(dr->mainWindowByName("mainWindowByName"), m.get());
+    CHECK(!dr->mainWindowByName("nonExisting"));
+
+    auto dock1 = createDockWidget("dockByName1", Platform::instance()->tests_createView({ true }), {}, {}, /*show=*/false);
+    auto dock2 = createDockWidget("dockByName2", Platform::instance()->tests_createView({ true }), {}, {}, /*show=*/false);
+    CHECK_EQ(dr->dockByName("dockByName1"), dock1);
+    CHECK_EQ(dr->dockByName("dockByName2"), dock2);
+    CHECK(!dr->dockByName("nonExisting"));
+
+    // Registration order is kept
+    const auto docks = dr->dockWidgets({ "dockByName2", "dockByName1" });
+    CHECK_EQ(docks.size(), 2);
+    CHECK_EQ(docks.at(0), dock1);
+    CHECK_EQ(docks.at(1), dock2);
+
+    delete dock1;
+    CHECK(!dr->dockByName("dockByName1"));
+    CHECK_EQ(dr->dockByName("dockByName2"), dock2);
+    delete dock2;
+
+    m.reset();
+    CHECK(!DockRegistry::self()->mainWindowByName("mainWindowByName"));
+
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_resizeWindow2()
 {
     // Tests that resizing the width of the main window will never move horizontal anchors
@@ -491,6 +525,232 @@ KDDW_QCORO_TASK tst_restoreNlohmanException()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_serializeLayoutMatchesDom()
+{
+    // serializeLayout() streams the JSON. Tests that it's the same as going through the
+    // intermediate LayoutSaver::Layout and nlohmann's DOM.
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_serializeLayoutMatchesDom");
+    auto dock1 = createDockWidget("1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("2", Platform::instance()->tests_createView({ true }));
+    auto dock3 = createDockWidget("3", Platform::instance()->tests_createView({ true }));
+    auto dock4 = createDockWidget("4", Platform::instance()->tests_createView({ true }));
+    auto dock5 = createDockWidget("5", Platform::instance()->tests_createView({ true }));
+    auto dock6 = createDockWidget("6 \"quoted\"", Platform::instance()->tests_createView({ true }));
+
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    m->addDockWidget(dock3, Location_OnBottom, dock2);
+    dock2->addDockWidgetAsTab(dock4);
+    dock5->addDockWidgetAsTab(dock6);
+    dock3->close();
+
+    LayoutSaver saver;
+    QByteArray saved;
+    CHECK(saver.serializeLayout(saved));
+    CHECK(!saved.isEmpty());
+    CHECK_EQ(saved, saver.serializeLayout());
+
+    LayoutSaver::Layout layout;
+    CHECK(layout.fromJson(saved));
+    CHECK_EQ(layout.toJson(), saved);
+
+    CHECK(saver.saveToFile(QStringLiteral("layout_tst_serializeLayoutMatchesDom.json")));
+    bool ok = false;
+    CHECK_EQ(Platform::instance()->readFile(QStringLiteral("layout_tst_serializeLayoutMatchesDom.json"), /*by-ref*/ ok), saved);
+    CHECK(ok);
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_serializeLayoutBinary()
+{
+    // LayoutSaverFormat::Binary must hold the same layout as JSON, and be restorable
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_serializeLayoutBinary");
+    auto dock1 = createDockWidget("1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("2", Platform::instance()->tests_createView({ true }));
+    auto dock3 = createDockWidget("3", Platform::instance()->tests_createView({ true }));
+    auto dock4 = createDockWidget("4", Platform::instance()->tests_createView({ true }));
+
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    m->addDockWidget(dock3, Location_OnBottom, dock2);
+    dock2->addDockWidgetAsTab(dock4);
+    dock4->setFloating(true);
+
+    LayoutSaver saver;
+    CHECK(saver.format() == LayoutSaverFormat::Json);
+    const QByteArray json = saver.serializeLayout();
+    CHECK(!LayoutSaver::Layout::isBinary(json));
+
+    saver.setFormat(LayoutSaverFormat::Binary);
+    const QByteArray binary = saver.serializeLayout();
+    CHECK(LayoutSaver::Layout::isBinary(binary));
+    CHECK(binary.size() < json.size());
+
+    {
+        LayoutSaver::Layout layout;
+        CHECK(layout.fromBinary(binary));
+        CHECK_EQ(layout.toJson(), json);
+    }
+
+    {
+        // The DOM based encoder must produce something equivalent
+        LayoutSaver::Layout layout;
+        CHECK(layout.fromJson(json));
+        LayoutSaver::Layout layout2;
+        CHECK(layout2.fromData(layout.toBinary()));
+        CHECK_EQ(layout2.toJson(), json);
+    }
+
+    // What kddockwidgets_linter --convert uses
+    CHECK_EQ(LayoutSaver::convertLayout(binary, LayoutSaverFormat::Json), json);
+    CHECK_EQ(LayoutSaver::convertLayout(LayoutSaver::convertLayout(json, LayoutSaverFormat::Binary), LayoutSaverFormat::Json), json);
+
+    // Truncated data is rejected
+    {
+        QByteArray truncated = binary;
+        truncated.resize(binary.size() / 2);
+        SetExpectedWarning ignoreWarning("Failed to parse layout data");
+        CHECK(!saver.restoreLayout(truncated));
+    }
+
+    // Restoring detects the format
+    dock1->close();
+    dock4->setFloating(false);
+    CHECK(saver.restoreLayout(binary));
+    CHECK(dock1->isOpen());
+    CHECK(dock4->isFloating());
+
+    CHECK(saver.saveToFile(QStringLiteral("layout_tst_serializeLayoutBinary.bin")));
+    dock2->close();
+    CHECK(saver.restoreFromFile(QStringLiteral("layout_tst_serializeLayoutBinary.bin")));
+    CHECK(dock2->isOpen());
+
+    saver.setFormat(LayoutSaverFormat::Json);
+    CHECK_EQ(saver.serializeLayout(), json);
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_restoreLayoutAsync()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_restoreLayoutAsync");
+    auto dock1 = createDockWidget("1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("2", Platform::instance()->tests_createView({ true }));
+    auto dock3 = createDockWidget("3", Platform::instance()->tests_createView({ true }));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    dock3->setFloating(true);
+
+    QByteArray saved;
+    {
+        LayoutSaver saver;
+        saved = saver.serializeLayout();
+    }
+
+    dock1->close();
+    dock2->setFloating(true);
+    dock3->close();
+
+    int numCallbacks = 0;
+    bool result = false;
+    auto waitForCallback = [&numCallbacks]() -> KDDW_QCORO_TASK {
+        for (int i = 0; i < 100 && numCallbacks == 0; ++i)
+            KDDW_CO_AWAIT Platform::instance()->tests_wait(50);
+        KDDW_CO_RETURN(numCallbacks == 1);
+    };
+
+    {
+        // The saver doesn't need to outlive the restore
+        LayoutSaver saver;
+        saver.restoreLayoutAsync(saved, [&numCallbacks, &result](bool ok) {
+            numCallbacks++;
+            result = ok;
+        });
+
+        // Applied later, on the GUI thread
+        CHECK_EQ(numCallbacks, 0);
+        CHECK(!dock1->isOpen());
+    }
+
+    CHECK(KDDW_CO_AWAIT waitForCallback());
+    CHECK(result);
+    CHECK(dock1->isOpen());
+    CHECK(dock2->isOpen());
+    CHECK(!dock2->isFloating());
+    CHECK(dock3->isFloating());
+    CHECK(m->layout()->checkSanity());
+
+    {
+        LayoutSaver saver;
+        CHECK_EQ(saver.serializeLayout(), saved);
+    }
+
+    // Same error handling as restoreLayout()
+    {
+        SetExpectedWarning ignoreWarning("Failed to parse layout data");
+        numCallbacks = 0;
+        result = true;
+        QByteArray truncated = saved;
+        truncated.resize(saved.size() / 2);
+        LayoutSaver saver;
+        saver.restoreLayoutAsync(truncated, [&numCallbacks, &result](bool ok) {
+            numCallbacks++;
+            result = ok;
+        });
+        CHECK(KDDW_CO_AWAIT waitForCallback());
+        CHECK(!result);
+    }
+
+    CHECK(dock1->isOpen());
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_serializeLayoutMatchesToJson()
+{
+    // serializeLayout() streams through each class' serialize(JsonWriter &), which mirrors its
+    // to_json(). Tests that both paths produce the same bytes, for every kind of object.
+    EnsureTopLevelsDeleted e;
+    auto m1 = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_serializeLayoutMatchesToJson1");
+    auto m2 = createMainWindow(Size(500, 500), MainWindowOption_HasCentralFrame, "tst_serializeLayoutMatchesToJson2");
+    Vector<Core::DockWidget *> docks;
+    for (int i = 0; i < 9; ++i)
+        docks.push_back(createDockWidget(QString("dock") + QString::number(i), Platform::instance()->tests_createView({ true })));
+
+    // Nested containers
+    m1->addDockWidget(docks[0], Location_OnLeft);
+    m1->addDockWidget(docks[1], Location_OnRight);
+    m1->addDockWidget(docks[2], Location_OnBottom, docks[1]);
+    m1->addDockWidget(docks[3], Location_OnRight, docks[2]);
+    docks[1]->addDockWidgetAsTab(docks[4]);
+
+    // Placeholders, as closed dock widgets remember where they were
+    docks[3]->close();
+    docks[4]->close();
+
+    // A floating window with more than one group
+    docks[5]->setFloating(true);
+    docks[5]->floatingWindow()->addDockWidget(docks[6], Location_OnBottom, nullptr);
+
+    // Affinities, which end up in the floating window too
+    docks[7]->setAffinities({ QStringLiteral("a1") });
+    docks[7]->setFloating(true);
+
+    // m2's central group stays empty. docks[8] was never shown.
+    CHECK(m2->dropArea()->groups().size() == 1);
+
+    LayoutSaver saver;
+    const QByteArray streamed = saver.serializeLayout();
+    CHECK(!streamed.isEmpty());
+    CHECK_EQ(streamed, saver.dptr()->serializeThroughLayout());
+
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_restoreEmpty()
 {
     EnsureTopLevelsDeleted e;
@@ -1977,6 +2237,35 @@ KDDW_QCORO_TASK tst_addAndReadd()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_coalesceDragHover()
+{
+    EnsureTopLevelsDeleted e;
+    KDDockWidgets::Config::self().setFlags(KDDockWidgets::Config::self().flags() | KDDockWidgets::Config::Flag_CoalesceDragHover);
+
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("dock2", Platform::instance()->tests_createView({ true }));
+    m->addDockWidget(dock1, KDDockWidgets::Location_OnLeft);
+
+    // The drop still goes where the indicators say, even if a hover was pending on release
+    auto fw = dock2->floatingWindow();
+    DragController::instance()->resetHoverStats();
+    KDDW_CO_AWAIT dragFloatingWindowTo(fw, m->dropArea(), DropLocation_Right);
+    CHECK(!dock2->isFloating());
+    CHECK(m->layout()->checkSanity());
+
+    // The test moves the mouse one pixel at a time, faster than once per frame
+    const auto stats = DragController::instance()->hoverStats();
+    CHECK(stats.mouseMoves > 0);
+    CHECK(stats.hoversComputed > 0);
+    CHECK(stats.hoversCoalesced > 0);
+    CHECK(stats.hoversComputed + stats.hoversCoalesced <= stats.mouseMoves);
+    CHECK(stats.hoversSkipped <= stats.hoversComputed);
+
+    KDDW_CO_AWAIT Platform::instance()->tests_waitForDeleted(fw);
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_addToSmallMainWindow1()
 {
     EnsureTopLevelsDeleted e;
@@ -2815,6 +3104,233 @@ KDDW_QCORO_TASK tst_restoreWithDockFactory2()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_restoreReuseGroups()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_restoreReuseGroups");
+    auto dock1 = createDockWidget("1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("2", Platform::instance()->tests_createView({ true }));
+    auto dock3 = createDockWidget("3", Platform::instance()->tests_createView({ true }));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    dock2->addDockWidgetAsTab(dock3);
+    dock3->setAsCurrentTab();
+
+    QByteArray saved;
+    {
+        LayoutSaver saver;
+        saved = saver.serializeLayout();
+    }
+
+    const Rect group1Geometry = dock1->dptr()->group()->geometry();
+    dock3->setFloating(true);
+    dock2->close();
+    Core::Group *group1 = dock1->dptr()->group();
+    CHECK(group1->geometry() != group1Geometry);
+
+    {
+        LayoutSaver saver(RestoreOption_ReuseGroups);
+        CHECK(saver.restoreLayout(saved));
+    }
+
+    // dock1's group didn't change, so it was kept and only resized
+    CHECK(dock1->isOpen());
+    CHECK(dock1->dptr()->group() == group1);
+    CHECK_EQ(group1->geometry(), group1Geometry);
+
+    // The other group had lost its tabs, so it was rebuilt
+    CHECK(dock2->isOpen());
+    CHECK(!dock3->isFloating());
+    CHECK(dock2->dptr()->group() == dock3->dptr()->group());
+    CHECK(dock3->isCurrentTab());
+    CHECK_EQ(m->layout()->count(), 2);
+    CHECK(m->layout()->checkSanity());
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_groupPool()
+{
+    EnsureTopLevelsDeleted e;
+    Config::self().setGroupPoolSize(2);
+    Core::GroupPool *pool = DockRegistry::self()->groupPool();
+    const Core::GroupPool::Stats initialStats = pool->stats();
+
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_groupPool");
+    auto dock1 = createDockWidget("1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("2", Platform::instance()->tests_createView({ true }));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+
+    // The floating windows' groups were emptied, they're recycled once the event loop runs
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+    CHECK_EQ(pool->stats().available, 2);
+    CHECK_EQ(Core::Group::dbg_numFrames(), 2);
+    CHECK_EQ(DockRegistry::self()->groups().size(), 2);
+
+    // Floating reuses a pooled group
+    dock1->setFloating(true);
+    CHECK_EQ(pool->stats().reused, initialStats.reused + 1);
+    CHECK(dock1->isFloating());
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+
+    // And redocking reuses the main window's emptied group
+    dock1->setFloating(false);
+    CHECK(dock1->isInMainWindow());
+    CHECK_EQ(pool->stats().reused, initialStats.reused + 2);
+    CHECK_EQ(m->layout()->count(), 2);
+    CHECK(m->layout()->checkSanity());
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+
+    // Pooled groups aren't counted as alive
+    CHECK_EQ(Core::Group::dbg_numFrames(), 2);
+    CHECK_EQ(DockRegistry::self()->groups().size(), 2);
+
+    // Over the cap, emptied groups are deleted
+    const Core::GroupPool::Stats stats = pool->stats();
+    CHECK_EQ(stats.available, 2);
+    Config::self().setGroupPoolSize(1);
+    dock2->setFloating(true);
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+    CHECK_EQ(pool->stats().reused, stats.reused + 1);
+    CHECK_EQ(pool->stats().discarded, stats.discarded + 1);
+    CHECK_EQ(pool->stats().available, 1);
+    CHECK_EQ(pool->stats().peak, 2);
+
+    Config::self().setGroupPoolSize(0);
+    pool->clear();
+    CHECK_EQ(pool->stats().available, 0);
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_floatingWindowPool()
+{
+    EnsureTopLevelsDeleted e;
+    Config::self().setFloatingWindowPoolSize(1);
+    Core::FloatingWindowPool *pool = DockRegistry::self()->floatingWindowPool();
+    const Core::FloatingWindowPool::Stats initialStats = pool->stats();
+
+    // Creating a main window warms up the pool once the event loop runs
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_floatingWindowPool");
+    CHECK_EQ(pool->stats().available, 0);
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+    CHECK_EQ(pool->stats().available, 1);
+    CHECK_EQ(pool->stats().created, initialStats.created + 1);
+
+    // Pooled windows aren't top-levels until handed out
+    CHECK(DockRegistry::self()->floatingWindows(/*includeBeingDeleted=*/true).isEmpty());
+
+    auto dock1 = createDockWidget("1", Platform::instance()->tests_createView({ true }));
+    CHECK_EQ(pool->stats().taken, initialStats.taken + 1);
+    CHECK_EQ(pool->stats().available, 0);
+    CHECK_EQ(DockRegistry::self()->floatingWindows().size(), 1);
+    CHECK(dock1->floatingWindow());
+    CHECK(dock1->floatingWindow()->isVisible());
+
+    m->addDockWidget(dock1, Location_OnLeft);
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+    CHECK_EQ(pool->stats().available, 1);
+
+    // Tearing off again reuses the refilled one
+    dock1->setFloating(true);
+    CHECK_EQ(pool->stats().taken, initialStats.taken + 2);
+    CHECK(dock1->isFloating());
+    CHECK(dock1->floatingWindow()->isVisible());
+    CHECK_EQ(dock1->floatingWindow()->mainWindow(), m.get());
+    CHECK(dock1->floatingWindow()->layout()->checkSanity());
+
+    dock1->setFloating(false);
+    CHECK(dock1->isInMainWindow());
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+    CHECK_EQ(pool->stats().available, 1);
+
+    // Windows parented to a main window go away with it
+    auto m2 = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_floatingWindowPool2");
+    KDDW_CO_AWAIT Platform::instance()->tests_wait(100);
+    CHECK_EQ(pool->stats().available, 2);
+    m2.reset();
+    CHECK_EQ(pool->stats().available, 1);
+
+    Config::self().setFloatingWindowPoolSize(0);
+    pool->clear();
+    CHECK_EQ(pool->stats().available, 0);
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_lazyGuestViews()
+{
+    // Restored dock widgets only get contents when they're visible
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_lazyGuestViews");
+    auto dock1 = createDockWidget("1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("2", Platform::instance()->tests_createView({ true }));
+    auto dock3 = createDockWidget("3", Platform::instance()->tests_createView({ true }));
+    auto dock4 = createDockWidget("4", Platform::instance()->tests_createView({ true }));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    dock2->addDockWidgetAsTab(dock3);
+    dock3->setAsCurrentTab();
+    m->addDockWidget(dock4, Location_OnBottom);
+    dock4->close();
+
+    LayoutSaver saver;
+    const QByteArray saved = saver.serializeLayout();
+    delete dock1;
+    delete dock2;
+    delete dock3;
+    delete dock4;
+
+    static int numGuestViewsCreated = 0;
+    numGuestViewsCreated = 0;
+
+    DockWidgetFactoryFunc dockFunc = [](const QString &name) {
+        // Cheap, no contents
+        return Config::self().viewFactory()->createDockWidget(name)->asDockWidgetController();
+    };
+
+    GuestViewFactoryFunc guestFunc = [](Core::DockWidget *dw) {
+        numGuestViewsCreated++;
+        dw->setGuestView(Platform::instance()->tests_createView({ true })->asWrapper());
+    };
+
+    Config::self().setDockWidgetFactoryFunc(dockFunc);
+    Config::self().setGuestViewFactoryFunc(guestFunc);
+    CHECK(saver.restoreLayout(saved));
+
+    dock1 = DockRegistry::self()->dockByName("1");
+    dock2 = DockRegistry::self()->dockByName("2");
+    dock3 = DockRegistry::self()->dockByName("3");
+    dock4 = DockRegistry::self()->dockByName("4");
+    CHECK(dock1 && dock2 && dock3 && dock4);
+    CHECK(dock2->isOpen());
+    CHECK(!dock4->isOpen());
+
+    // Only the visible ones got contents
+    CHECK(dock1->guestView());
+    CHECK(!dock2->guestView());
+    CHECK(dock3->guestView());
+    CHECK(!dock4->guestView());
+    CHECK_EQ(numGuestViewsCreated, 2);
+
+    // Activating the background tab creates its contents
+    dock2->setAsCurrentTab();
+    CHECK(dock2->guestView());
+    CHECK_EQ(numGuestViewsCreated, 3);
+
+    // And so does opening the closed one
+    dock4->open();
+    CHECK(dock4->guestView());
+    CHECK_EQ(numGuestViewsCreated, 4);
+
+    // Only once
+    dock3->setAsCurrentTab();
+    CHECK_EQ(numGuestViewsCreated, 4);
+
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_addDockWidgetToMainWindow()
 {
     EnsureTopLevelsDeleted e;
@@ -4866,6 +5382,36 @@ KDDW_QCORO_TASK tst_redockToMDIRestoresPosition()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_mdiZOrder()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(1000, 800), MainWindowOption_MDI);
+    auto layout = m->layout()->asMDILayout();
+
+    auto dock0 = createDockWidget("dock0", Platform::instance()->tests_createView({ true }));
+    auto dock1 = createDockWidget("dock1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("dock2", Platform::instance()->tests_createView({ true }));
+    layout->addDockWidget(dock0, Point(0, 0), {});
+    layout->addDockWidget(dock1, Point(0, 0), {});
+    layout->addDockWidget(dock2, Point(0, 0), {});
+
+    Core::Group *group0 = dock0->DockWidget::d->group();
+    Core::Group *group1 = dock1->DockWidget::d->group();
+    Core::Group *group2 = dock2->DockWidget::d->group();
+
+    // Added ones are in front
+    CHECK_EQ(layout->groupsInZOrder(), Vector<Core::Group *>({ group0, group1, group2 }));
+
+    layout->raiseGroup(group0);
+    CHECK_EQ(layout->groupsInZOrder(), Vector<Core::Group *>({ group1, group2, group0 }));
+
+    // Moving doesn't change the z-order
+    layout->moveDockWidget(group2, Point(100, 100));
+    CHECK_EQ(layout->groupsInZOrder(), Vector<Core::Group *>({ group1, group2, group0 }));
+
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_restoreWithNativeTitleBar()
 {
 #ifdef Q_OS_WIN // Other OS don't support this
@@ -5406,6 +5952,7 @@ static const auto s_tests = std::vector<KDDWTest>
 {
     TEST(tst_simple1),
         TEST(tst_simple2),
+        TEST(tst_dockByName),
         TEST(tst_resizeWindow2),
         TEST(tst_hasLastDockedLocation),
         TEST(tst_ghostSeparator),
@@ -5417,6 +5964,14 @@ static const auto s_tests = std::vector<KDDWTest>
         TEST(tst_dragOverTitleBar),
         TEST(tst_setFloatingGeometry),
         TEST(tst_restoreEmpty),
+        TEST(tst_serializeLayoutMatchesDom),
+        TEST(tst_serializeLayoutMatchesToJson),
+        TEST(tst_serializeLayoutBinary),
+        TEST(tst_restoreLayoutAsync),
+        TEST(tst_lazyGuestViews),
+        TEST(tst_restoreReuseGroups),
+        TEST(tst_groupPool),
+        TEST(tst_floatingWindowPool),
         TEST(tst_restoreCentralFrame),
         TEST(tst_restoreNonExistingDockWidget),
         TEST(tst_shutdown),
@@ -5542,6 +6097,7 @@ static const auto s_tests = std::vector<KDDWTest>
         TEST(tst_nonDockable),
         TEST(tst_flagDoubleClick),
         TEST(tst_constraintsAfterPlaceholder),
+        TEST(tst_coalesceDragHover),
         TEST(tst_addToSmallMainWindow1),
         TEST(tst_addToSmallMainWindow2),
         TEST(tst_addToSmallMainWindow3),
@@ -5550,6 +6106,7 @@ static const auto s_tests = std::vector<KDDWTest>
         TEST(tst_currentTabMatchesDockWidget),
         TEST(tst_addMDIDockWidget),
         TEST(tst_redockToMDIRestoresPosition),
+        TEST(tst_mdiZOrder),
         TEST(tst_maximizeButton),
 #endif
         TEST(tst_keepLast)
@@ -16,6 +16,7 @@
 #include "core/layouting/LayoutingGuest_p.h"
 #include "core/layouting/LayoutingSeparator_p.h"
 #include "core/DropArea.h"
+#include "Config.h"
 #include "core/View_p.h"
 #include "core/Utils_p.h"
 #include "core/ObjectGuard_p.h"
@@ -984,6 +985,36 @@ KDDW_QCORO_TASK tst_suggestedRect4()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_layoutGeneration()
+{
+    // Tests that Item::layoutGeneration() changes when the layout does, so cached drop rects
+    // get invalidated
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    Item *item1 = createItem();
+    Item *item2 = createItem();
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+
+    uint64_t generation = Item::layoutGeneration();
+    root->setSize_recursive(root->size());
+    CHECK_EQ(generation, Item::layoutGeneration());
+
+    root->setSize_recursive(root->size() + Size(100, 0));
+    CHECK(generation != Item::layoutGeneration());
+
+    generation = Item::layoutGeneration();
+    item2->turnIntoPlaceholder();
+    CHECK(generation != Item::layoutGeneration());
+
+    generation = Item::layoutGeneration();
+    item1->setMinSize(Size(200, 200));
+    CHECK(generation != Item::layoutGeneration());
+
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_insertAnotherRoot()
 {
     DeleteViews deleteViews;
@@ -1218,6 +1249,205 @@ KDDW_QCORO_TASK tst_numSeparators()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_separatorPool()
+{
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    LayoutingHost *host = root->host();
+    Item *item1 = createItem();
+    Item *item2 = createItem();
+    Item *item3 = createItem();
+
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+    root->insertItem(item3, Location_OnRight);
+    CHECK_EQ(root->separators_recursive().size(), 2);
+    CHECK_EQ(host->separatorPoolStats().available, 0);
+
+    // The unused separator is pooled, not deleted
+    root->removeItem(item3);
+    CHECK_EQ(root->separators_recursive().size(), 1);
+    CHECK_EQ(host->separatorPoolStats().available, 1);
+    CHECK_EQ(host->separatorPoolStats().peak, 1);
+
+    // And recycled by the next insertion
+    Item *item4 = createItem();
+    root->insertItem(item4, Location_OnRight);
+    CHECK_EQ(root->separators_recursive().size(), 2);
+    CHECK_EQ(host->separatorPoolStats().available, 0);
+    CHECK_EQ(host->separatorPoolStats().reused, 1);
+    for (LayoutingSeparator *separator : root->separators_recursive())
+        CHECK_EQ(separator->parentContainer(), root.get());
+
+    CHECK(root->checkSanity());
+    CHECK(serializeDeserializeTest(root));
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_separatorPoolCap()
+{
+    DeleteViews deleteViews;
+
+    // Restored even if a CHECK fails
+    struct PoolSizeRestorer
+    {
+        const int size = Config::self().separatorPoolSize();
+        ~PoolSizeRestorer()
+        {
+            Config::self().setSeparatorPoolSize(size);
+        }
+    } restorer;
+    Config::self().setSeparatorPoolSize(3);
+
+    auto root = createRoot();
+    LayoutingHost *host = root->host();
+    Item *item1 = createItem();
+    Item *item2 = createItem();
+    Item *item3 = createItem();
+    Item *item4 = createItem();
+    Item *item5 = createItem();
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+    root->insertItem(item3, Location_OnRight);
+    root->insertItem(item4, Location_OnRight);
+    root->insertItem(item5, Location_OnRight);
+    CHECK_EQ(root->separators_recursive().size(), 4);
+    const int discarded = host->separatorPoolStats().discarded;
+
+    root->removeItem(item5);
+    root->removeItem(item4);
+    root->removeItem(item3);
+    CHECK_EQ(root->separators_recursive().size(), 1);
+    CHECK_EQ(host->separatorPoolStats().available, 3);
+    CHECK_EQ(host->separatorPoolStats().discarded, discarded);
+
+    // Lowering the cap trims the pool on the next release
+    Config::self().setSeparatorPoolSize(1);
+    root->removeItem(item2);
+    CHECK_EQ(root->separators_recursive().size(), 0);
+    CHECK_EQ(host->separatorPoolStats().available, 1);
+    CHECK_EQ(host->separatorPoolStats().discarded, discarded + 3);
+    CHECK(root->checkSanity());
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_itemAt()
+{
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    Item *item1 = createItem();
+    Item *item2 = createItem();
+    Item *item3 = createItem();
+    Item *item4 = createItem();
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+    root->insertItem(item3, Location_OnRight);
+    ItemBoxContainer::insertItemRelativeTo(item4, item2, Location_OnBottom);
+    CHECK(item4->parentBoxContainer() != root.get());
+
+    for (Item *item : { item1, item2, item3, item4 }) {
+        const Rect geo = item->mapToRoot(item->rect());
+        CHECK_EQ(root->itemAt_recursive(geo.center()), item);
+        CHECK_EQ(root->itemAt_recursive(geo.topLeft()), item);
+        CHECK_EQ(root->itemAt_recursive(geo.bottomRight()), item);
+    }
+
+    // Separators and the outside aren't inside any item
+    const Rect geo1 = item1->mapToRoot(item1->rect());
+    CHECK(!root->itemAt_recursive(Point(geo1.right() + 1, geo1.center().y())));
+    CHECK(!root->itemAt_recursive(Point(-1, -1)));
+    CHECK(!root->itemAt_recursive(Point(root->width(), root->height())));
+
+    // Placeholders are skipped, the layout changing invalidates the cached positions
+    item2->turnIntoPlaceholder();
+    const Rect geo4 = item4->mapToRoot(item4->rect());
+    CHECK_EQ(root->itemAt_recursive(geo4.topLeft()), item4);
+    const Rect geo3 = item3->mapToRoot(item3->rect());
+    CHECK_EQ(root->itemAt_recursive(geo3.center()), item3);
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_visitRecursive()
+{
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    Item *item1 = createItem();
+    Item *item2 = createItem();
+    Item *item3 = createItem();
+    Item *item4 = createItem();
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+    root->insertItem(item3, Location_OnRight);
+    ItemBoxContainer::insertItemRelativeTo(item4, item2, Location_OnBottom);
+    item3->turnIntoPlaceholder();
+
+    auto collect = [&root](ItemContainer::VisitFilter filter) {
+        Item::List result;
+        root->visit_recursive([&result](Item *item) { result.push_back(item); }, filter);
+        return result;
+    };
+
+    // Same order as items_recursive()
+    CHECK_EQ(collect(ItemContainer::VisitFilter::Leaves), root->items_recursive());
+    CHECK_EQ(collect(ItemContainer::VisitFilter::Leaves).size(), 4);
+    CHECK_EQ(collect(ItemContainer::VisitFilter::VisibleLeaves), Item::List({ item1, item2, item4 }));
+    CHECK_EQ(collect(ItemContainer::VisitFilter::Placeholders), Item::List({ item3 }));
+    CHECK_EQ(collect(ItemContainer::VisitFilter::Containers),
+             Item::List({ item2->parentContainer() }));
+
+    // Returning false stops the visit
+    int visited = 0;
+    const bool completed = root->visit_recursive([&visited, item2](Item *item) {
+        ++visited;
+        return item != item2;
+    });
+    CHECK(!completed);
+    CHECK_EQ(visited, 2);
+
+    KDDW_TEST_RETURN(true);
+}
+
+KDDW_QCORO_TASK tst_itemForView()
+{
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    Item *item1 = createItem();
+    Item *item2 = createItem();
+    Item *item3 = createItem();
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+    ItemBoxContainer::insertItemRelativeTo(item3, item2, Location_OnBottom);
+    ItemContainer *nested = item3->parentContainer();
+    CHECK(nested != root.get());
+
+    CHECK_EQ(root->itemForView(item1->guest()), item1);
+    CHECK_EQ(root->itemForView(item3->guest()), item3);
+    CHECK_EQ(nested->itemForView(item3->guest()), item3);
+    CHECK(!root->itemForView(nullptr));
+
+    // Only searches below itself
+    CHECK(!nested->itemForView(item1->guest()));
+
+    // Items of another layout aren't found
+    auto root2 = createRoot();
+    Item *other = root2->childItems().constFirst();
+    CHECK(!root->itemForView(other->guest()));
+
+    // Placeholders don't have a guest anymore
+    LayoutingGuest *guest1 = item1->guest();
+    item1->turnIntoPlaceholder();
+    CHECK(!root->itemForView(guest1));
+
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_separatorMinMax()
 {
     DeleteViews deleteViews;
@@ -1676,6 +1906,44 @@ KDDW_QCORO_TASK tst_minSizeChangedBeforeRestore()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_minSizeAfterRestore()
+{
+    DeleteViews deleteViews;
+
+    // Restoring replaces the root's children. The host's min size must still follow them.
+    auto dropArea = new DropArea(nullptr, MainWindowOption_None);
+    s_views.push_back(dropArea);
+    auto root = object_cast<ItemBoxContainer *>(dropArea->rootItem());
+    CHECK(root);
+
+    auto item1 = createItem(Size(100, 100));
+    auto item2 = createItem(Size(100, 100));
+    root->insertItem(item1, Location_OnTop);
+    root->insertItem(item2, Location_OnBottom);
+    CHECK_EQ(dropArea->view()->minSize(), root->minSize());
+
+    std::unordered_map<QString, LayoutingGuest *> widgets;
+    for (Item *item : root->items_recursive())
+        if (auto guest = item->guest())
+            widgets[guest->id()] = guest;
+    auto guest2 = item2->guest();
+
+    nlohmann::json serialized;
+    root->to_json(serialized);
+    root->clear();
+    root->fillFromJson(serialized, widgets);
+    CHECK(root->checkSanity());
+    CHECK_EQ(dropArea->view()->minSize(), root->minSize());
+
+    // Growing a restored item's min size grows the host's
+    const Size oldMinSize = root->minSize();
+    dynamic_cast<Guest *>(guest2)->m_view->setMinimumSize(Size(100, 300));
+    CHECK(root->minSize() != oldMinSize);
+    CHECK_EQ(dropArea->view()->minSize(), root->minSize());
+
+    KDDW_TEST_RETURN(true);
+}
+
 KDDW_QCORO_TASK tst_separatorMoveCrash()
 {
     DeleteViews deleteViews;
@@ -2167,6 +2435,40 @@ KDDW_QCORO_TASK tst_relayoutIfNeeded()
     KDDW_TEST_RETURN(true);
 }
 
+KDDW_QCORO_TASK tst_layoutTransaction()
+{
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    auto item1 = createItem();
+    auto item2 = createItem();
+    auto item3 = createItem();
+
+    {
+        LayoutTransaction transaction(root.get());
+        root->insertItem(item1, Location_OnLeft);
+        root->insertItem(item2, Location_OnRight);
+        ItemBoxContainer::insertItemRelativeTo(item3, item2, Location_OnBottom);
+
+        // Separators are only created when the transaction ends
+        CHECK(root->separators_recursive().isEmpty());
+
+        {
+            // Nested transactions don't apply anything
+            LayoutTransaction nested(item3);
+        }
+
+        CHECK(root->separators_recursive().isEmpty());
+    }
+
+    CHECK_EQ(root->separators_recursive().size(), 2);
+    CHECK_EQ(item3->guest()->geometry(), item3->mapToRoot(item3->rect()));
+    CHECK(root->checkSanity());
+    CHECK(serializeDeserializeTest(root));
+
+    KDDW_TEST_RETURN(true);
+}
+
 static const std::vector<KDDWTest> s_tests = {
     TEST(tst_createRoot),
     TEST(tst_insertOne),
@@ -2191,6 +2493,7 @@ static const std::vector<KDDWTest> s_tests = {
     TEST(tst_suggestedRect2),
     TEST(tst_suggestedRect3),
     TEST(tst_suggestedRect4),
+    TEST(tst_layoutGeneration),
     TEST(tst_insertAnotherRoot),
     TEST(tst_misc1),
     TEST(tst_misc2),
@@ -2198,6 +2501,11 @@ static const std::vector<KDDWTest> s_tests = {
     TEST(tst_containerGetsHidden),
     TEST(tst_minSizeChanges),
     TEST(tst_numSeparators),
+    TEST(tst_separatorPool),
+    TEST(tst_separatorPoolCap),
+    TEST(tst_itemAt),
+    TEST(tst_visitRecursive),
+    TEST(tst_itemForView),
     TEST(tst_separatorMinMax),
     TEST(tst_separatorRecreatedOnParentChange),
     TEST(tst_containerReducesSize),
@@ -2210,6 +2518,7 @@ static const std::vector<KDDWTest> s_tests = {
     TEST(tst_mapToRoot),
     TEST(tst_closeAndRestorePreservesPosition),
     TEST(tst_minSizeChangedBeforeRestore),
+    TEST(tst_minSizeAfterRestore),
     TEST(tst_separatorMoveCrash),
     TEST(tst_separatorMoveHonoursMax),
     TEST(tst_maxSizeHonoured1),
@@ -2223,6 +2532,7 @@ static const std::vector<KDDWTest> s_tests = {
     TEST(tst_sizingInfoSerialization),
     TEST(tst_itemSerialization),
     TEST(tst_relayoutIfNeeded),
+    TEST(tst_layoutTransaction),
 };
 
 #include "tests_main.h"
@@ -18,6 +18,8 @@
 #include "core/Logging_p.h"
 #include "kddockwidgets/KDDockWidgets.h"
 #include "core/DockRegistry.h"
+#include "core/FloatingWindowPool_p.h"
+#include "core/GroupPool_p.h"
 #include "core/DropIndicatorOverlay.h"
 #include "core/DropArea.h"
 #include "core/TitleBar.h"
@@ -104,10 +106,17 @@ struct EnsureTopLevelsDeleted
         // Other cleanup, since we use this class everywhere
         Config::self().setDockWidgetFactoryFunc(nullptr);
         Config::self().setMainWindowFactoryFunc(nullptr);
+        Config::self().setGuestViewFactoryFunc(nullptr);
         Config::self().setInternalFlags(m_originalInternalFlags);
         Config::self().setFlags(m_originalFlags);
         Config::self().setSeparatorThickness(m_originalSeparatorThickness);
         Config::self().setLayoutSaverStrictMode(false);
+
+        // Pooled groups and windows would otherwise outlive a test that failed before cleaning up
+        Config::self().setGroupPoolSize(0);
+        Config::self().setFloatingWindowPoolSize(0);
+        DockRegistry::self()->groupPool()->clear();
+        DockRegistry::self()->floatingWindowPool()->clear();
     }
 
     const Config::Flags m_originalFlags;